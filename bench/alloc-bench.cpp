@@ -0,0 +1,136 @@
+// checks that a frame does not allocate once the scene is loaded, exits with 1 when the steady state allocates
+// or when a position or velocity stops being finite, a broken scene would measure nothing
+//
+// g++ -O2 -std=c++17 -DPHYSICS_COUNT_ALLOCATIONS bench/alloc-bench.cpp src/graphs/*.cpp src/physics/*.cpp src/render/*.cpp -o build/alloc-bench <SFML flags>
+// build/alloc-bench [frames] [balls] [soft bodys]
+#include "../include/physics/allocation-counter.hpp"
+#include "../include/physics/frame-arena.hpp"
+#include "../include/physics/metrics.hpp"
+#include "../include/physics/morton.hpp"
+#include "../include/physics/simulation.hpp"
+#include "../include/physics/spatial-grid.hpp"
+#include "../include/graphs/rope.hpp"
+#include "../include/graphs/scene.hpp"
+#include "../include/graphs/soft-body.hpp"
+#include "../include/graphs/static-world.hpp"
+#include "../include/render/camera.hpp"
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// frames run before counting, the containers reach their final capacity and the morton order settles
+static const int WARM_UP_FRAMES = 300;
+// the seed of the second golden scene, it stays finite with the default balls and soft bodys
+static const unsigned SCENE_SEED = 2;
+
+static bool isFinite(const graphs::Ball &ball)
+{
+    return std::isfinite(ball.pos.x) && std::isfinite(ball.pos.y) && std::isfinite(ball.vel.x) && std::isfinite(ball.vel.y);
+}
+
+// counts the balls, corners and links whose position or velocity is not finite
+static int countNonFinite()
+{
+    int count = 0;
+    for (const graphs::Ball &ball : graphs::Balls)
+    {
+        count += !isFinite(ball);
+    }
+    for (const graphs::SoftBody &softBody : graphs::SoftBodys)
+    {
+        for (const graphs::Ball &corner : softBody.cornerBalls)
+        {
+            count += !isFinite(corner);
+        }
+    }
+    for (const graphs::Rope &rope : graphs::Ropes)
+    {
+        for (const graphs::Ball &link : rope.links)
+        {
+            count += !isFinite(link);
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!physics::isCountingAllocations())
+    {
+        std::cerr << "compile with -DPHYSICS_COUNT_ALLOCATIONS" << std::endl;
+        return 2;
+    }
+
+    int numberOfFrames = (argc > 1) ? std::stoi(argv[1]) : 600;
+    int numberOfBalls = (argc > 2) ? std::stoi(argv[2]) : 30;
+    int numberOfSoftBodys = (argc > 3) ? std::stoi(argv[3]) : 3;
+
+    graphs::World.addPolyline({linalg::Vector(80.f, 620.f), linalg::Vector(300.f, 700.f), linalg::Vector(420.f, 700.f)});
+    graphs::World.addSegment(linalg::Vector(780.f, 720.f), linalg::Vector(1120.f, 600.f));
+    graphs::World.build();
+    graphs::Scene::random(SCENE_SEED, numberOfBalls, numberOfSoftBodys).load();
+
+    // the frame of the window without the window: physics, metrics, storage order, picking and drawing
+    physics::SpatialGrid grid;
+    physics::MortonOrder mortonOrder;
+    std::vector<physics::SpatialItem> pickedItems;
+    render::Camera camera(sf::Vector2f(1200.f, 900.f), graphs::World.bounds.center());
+    render::CulledRenderer renderer;
+    sf::RenderTexture texture;
+    bool isDrawing = texture.resize({1200, 900});
+    if (!isDrawing)
+    {
+        std::cerr << "no render texture, drawing is not measured" << std::endl;
+    }
+
+    long long steadyAllocations = 0;
+    int allocatingFrames = 0;
+    int firstNonFiniteFrame = -1;
+    for (int frame = 0; frame < WARM_UP_FRAMES + numberOfFrames; frame++)
+    {
+        long long start = physics::allocationCount();
+
+        physics::frameArena.reset();
+        physics::metrics.beginStep();
+        physics::step();
+        physics::metrics.endStep();
+        mortonOrder.update();
+
+        grid.build();
+        grid.queryPoint(linalg::Vector(600.f, 450.f), 0.f, pickedItems);
+
+        if (isDrawing)
+        {
+            camera.zoomAt((frame % 120 < 60) ? 0.99f : 1.f / 0.99f, linalg::Vector(600.f, 450.f));
+            texture.setView(camera.view);
+            texture.clear(sf::Color::Black);
+            graphs::World.draw(texture);
+            renderer.draw(texture, grid, camera);
+            texture.display();
+        }
+
+        long long allocations = physics::allocationCount() - start;
+        if (firstNonFiniteFrame < 0 && countNonFinite() > 0)
+        {
+            firstNonFiniteFrame = frame;
+            std::cerr << "frame " << frame << ": " << countNonFinite() << " balls are not finite" << std::endl;
+        }
+        if (frame >= WARM_UP_FRAMES && allocations > 0)
+        {
+            if (allocatingFrames++ < 10)
+            {
+                std::cerr << "frame " << frame << ": " << allocations << " allocations" << std::endl;
+            }
+            steadyAllocations += allocations;
+        }
+    }
+
+    std::cout << "steady state: " << steadyAllocations << " allocations in " << allocatingFrames << " of " << numberOfFrames << " frames, "
+              << "arena high water " << physics::frameArena.highWater << " bytes" << std::endl;
+    if (firstNonFiniteFrame >= 0)
+    {
+        std::cerr << "the scene is not finite from frame " << firstNonFiniteFrame << ", the counts do not hold" << std::endl;
+        return 1;
+    }
+    return (steadyAllocations > 0) ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+// measures how the Z-order storage of the balls changes the cost of neighbour queries on a large scene,
+// and the cost of physics::step, whose collision loops visit every pair, on a smaller one
+//
+// g++ -O2 -std=c++17 bench/morton-bench.cpp src/graphs/*.cpp src/physics/*.cpp -o build/morton-bench <SFML flags>
+// perf stat -e cache-misses,cache-references build/morton-bench [balls=200000] [repeats=5] [step balls=3000] [step frames=60]
+#include "../include/physics/morton.hpp"
+#include "../include/physics/simulation.hpp"
+#include "../include/physics/spatial-grid.hpp"
+#include "../include/graphs/spring.hpp"
+#include "../include/graphs/static-world.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+// a square arena filled with small balls, created in random order like a scene that has mixed for a while
+static void fillArena(int numberOfBalls, float size)
+{
+    graphs::Springs.clear();
+    graphs::SoftBodys.clear();
+    graphs::Balls.clear();
+    graphs::World.bounds = linalg::AABB(linalg::Vector(0.f, 0.f), linalg::Vector(size, size));
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> position(0.f, size);
+    graphs::Balls.reserve(numberOfBalls);
+    for (int i = 0; i < numberOfBalls; i++)
+    {
+        graphs::Balls.emplace_back(linalg::Vector(position(gen), position(gen)), sf::Color::White, 8.f, 1.f, 0.5f);
+    }
+}
+
+// runs the simulation for some frames, returns milliseconds per frame and the mean height of the balls at the end
+static double stepPass(int frames, double &meanHeight)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        physics::step();
+    }
+    double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    meanHeight = 0.0;
+    for (const graphs::Ball &ball : graphs::Balls)
+    {
+        meanHeight += ball.pos.y / graphs::Balls.size();
+    }
+    return time;
+}
+
+// visits the neighbours of every ball through the grid, the way a broadphase does
+static double neighbourPass(physics::SpatialGrid &grid, int repeats, long long &overlaps)
+{
+    std::vector<physics::SpatialItem> candidates;
+    auto start = std::chrono::steady_clock::now();
+
+    overlaps = 0;
+    for (int repeat = 0; repeat < repeats; repeat++)
+    {
+        for (const graphs::Ball &ball : graphs::Balls)
+        {
+            grid.queryBox(linalg::AABB::fromCircle(ball.pos, ball.radius * 2.f), candidates);
+            for (const physics::SpatialItem &item : candidates)
+            {
+                const graphs::Ball &other = physics::SpatialGrid::getBall(item);
+                float radii = ball.radius + other.radius;
+                overlaps += (&other != &ball) && (ball.pos - other.pos).dot(ball.pos - other.pos) < radii * radii;
+            }
+        }
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfBalls = (argc > 1) ? std::stoi(argv[1]) : 200000;
+    int repeats = (argc > 2) ? std::stoi(argv[2]) : 5;
+    int numberOfStepBalls = (argc > 3) ? std::stoi(argv[3]) : 3000;
+    int numberOfFrames = (argc > 4) ? std::stoi(argv[4]) : 60;
+
+    fillArena(numberOfBalls, 20000.f);
+
+    physics::SpatialGrid grid(32.f, 1 << 20);
+    physics::MortonOrder order;
+    long long overlaps = 0;
+
+    grid.build();
+    float disorder = order.measure();
+    double scattered = neighbourPass(grid, repeats, overlaps);
+    std::cout << "scattered: " << scattered << " ms per pass, disorder " << disorder << ", overlaps " << overlaps << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    order.reorder();
+    double reorderTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    grid.build();
+    disorder = order.measure();
+    double sorted = neighbourPass(grid, repeats, overlaps);
+    std::cout << "z-order:   " << sorted << " ms per pass, disorder " << disorder << ", overlaps " << overlaps << std::endl;
+    std::cout << "reorder:   " << reorderTime << " ms, speedup " << scattered / sorted << "x" << std::endl;
+
+    // the same scene stepped from the creation order and from the Z-order
+    // the collision loops resolve the pairs in storage order, so the two runs diverge after the first contacts, only the mean is comparable
+    double meanHeight = 0.0;
+    fillArena(numberOfStepBalls, 1500.f);
+    double scatteredStep = stepPass(numberOfFrames, meanHeight);
+    std::cout << "step scattered: " << scatteredStep << " ms per frame, mean height " << meanHeight << std::endl;
+
+    fillArena(numberOfStepBalls, 1500.f);
+    order.reorder();
+    double sortedStep = stepPass(numberOfFrames, meanHeight);
+    std::cout << "step z-order:   " << sortedStep << " ms per frame, mean height " << meanHeight << ", speedup " << scatteredStep / sortedStep << "x" << std::endl;
+
+    return 0;
+}
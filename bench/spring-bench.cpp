@@ -0,0 +1,52 @@
+// measures how the time to build a spring network grows with its size, it should be linear
+//
+// g++ -O2 -std=c++17 bench/spring-bench.cpp src/graphs/*.cpp src/physics/*.cpp -o build/spring-bench <SFML flags>
+// build/spring-bench [springs=1000000]
+#include "../include/graphs/spring-network.hpp"
+#include "../include/graphs/spring.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// builds a cloth with about springCount springs and loads it into the world, returns milliseconds
+static double buildCloth(int springCount, long long &springs)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // a square cloth with shear springs has about four springs per ball
+    int side = static_cast<int>(std::sqrt(springCount / 4.0)) + 1;
+    graphs::Scene scene;
+    graphs::SpringNetwork network(scene, {linalg::Vector(0.f, 0.f), sf::Color::White, 2.f, 1.f, 0.5f}, 0.5f);
+    network.addCloth(linalg::Vector(0.f, 0.f), side, side, 5.f);
+
+    // every edge once more in the other direction, all of them are rejected
+    std::vector<std::array<int, 2>> reversed;
+    reversed.reserve(scene.springs.size());
+    for (const graphs::SpringSpec &spring : scene.springs)
+    {
+        reversed.push_back({spring.ball2, spring.ball1});
+    }
+    if (network.addEdges(reversed) != 0)
+    {
+        std::cerr << "repeated edges were added" << std::endl;
+    }
+
+    scene.load();
+    springs = graphs::Springs.size();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int springCount = (argc > 1) ? std::stoi(argv[1]) : 1000000;
+
+    // a quarter, a half and the whole size, the time per spring should stay about the same
+    for (int divisor : {4, 2, 1})
+    {
+        long long springs = 0;
+        double milliseconds = buildCloth(springCount / divisor, springs);
+        std::cout << springs << " springs: " << milliseconds << " ms, " << milliseconds * 1e6 / springs << " ns per spring" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "vector.hpp"
+
+namespace linalg
+{
+    class AABB
+    {
+    public:
+        // properties
+        Vector min, max;
+
+        // constructer
+        AABB(Vector min = Vector(0.f, 0.f), Vector max = Vector(0.f, 0.f));
+
+        // methods
+        Vector center() const;                      // returns center of the box
+        Vector size() const;                        // returns width and height of the box
+        bool contains(const Vector &point) const;   // returns true if the point is inside the box
+        bool overlaps(const AABB &box) const;       // returns true if two boxes overlap
+        AABB merge(const AABB &box) const;          // returns the box that covers both boxes
+        AABB intersect(const AABB &box) const;      // returns the box both boxes cover, only valid if they overlap
+        AABB expand(float margin) const;            // returns the box grown by margin on every side
+        static AABB fromSegment(const Vector &start, const Vector &end);
+        static AABB fromCircle(const Vector &center, float radius);
+    };
+}
@@ -6,7 +6,8 @@ namespace graphs
 {
     class Ball;
     class Spring;
-    extern std::vector<Ball> Balls;
+    class SoftBody;
+    extern thread_local std::vector<Ball> Balls;
 
     class Ball
     {
@@ -16,6 +17,7 @@ namespace graphs
         sf::Color color;
         linalg::Vector prevPos, pos, vel, acc, force, gravity, frictionForce, dragForce, springForce, pressureForce;
         float radius, mass, elasticity;
+        float stepTime; // time of the sub-step the ball has moved through, 0 until it integrates
         bool isBeingDragged, isTouchWall;
 
         // constructer
@@ -23,12 +25,22 @@ namespace graphs
 
         // methods
         void update(float dt);
-        void draw(sf::RenderWindow &window);
+        void draw(sf::RenderTarget &target);
         void computeDragForce();
         void computeFrictionForce();
         void projectileMotion(linalg::Vector &mousePos, float elapsed);
         void checkBallCollision(Ball &ball);
         void checkSpringCollision(graphs::Spring &spring);
+        void checkEdgeCollision(graphs::Ball &start, graphs::Ball &end); // segment between two balls, it is pushed like a spring
+        void checkSegmentCollision(const linalg::Vector &start, const linalg::Vector &end);
         void checkWallCollision();
+
+        // continuous collision detection
+        bool isFastMover(float deltaTime) const;
+        linalg::Vector positionAt(float time) const; // on its path through the sub-step, where the sweeps of other balls meet it
+        float sweptBallCollision(const graphs::Ball &ball, float deltaTime, float elapsedTime = 0.f) const; // returns the time of impact as a fraction of deltaTime, greater than 1 if there is none, the other ball is met at elapsedTime of the sub-step
+        float sweptSegmentCollision(const linalg::Vector &start, const linalg::Vector &end, const linalg::Vector &segmentVel, float deltaTime) const;
+        float sweptSpringCollision(const graphs::Spring &spring, float deltaTime, float elapsedTime = 0.f) const; // same, for a spring moving with the mean velocity of its ends
+        void sweptUpdate(float deltaTime, const graphs::SoftBody *ignoredBody = nullptr);
     };
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include "vector.hpp"
+#include "aabb.hpp"
+#include "ball.hpp"
+#include "spring.hpp"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+namespace graphs
+{
+    class Rope;
+    extern thread_local std::vector<graphs::Rope> Ropes;
+
+    // inextensible chain of balls, its links are distance constraints solved together instead of stiff springs
+    class Rope
+    {
+    public:
+        // properties
+        std::vector<graphs::Ball> links;
+        std::vector<graphs::Spring> segments; // carry no force, they are used for collisions and drawing like springs
+        linalg::Vector anchor;                // the first link is held here while the rope is pinned
+        linalg::AABB bounds;                  // box of all links, rejects far objects before the link tests
+        sf::Color color;
+        float linkLength, mass, elasticity;
+        float tension; // largest link force of the last step
+        bool isPinned;
+
+        // constructer, the segments refer to the links, so a rope can be moved but not copied
+        Rope(linalg::Vector start, linalg::Vector end, int linkCount, sf::Color color, float linkRadius, float mass, float elasticity, bool isPinned = true);
+        Rope(const Rope &) = delete;
+        Rope &operator=(const Rope &) = delete;
+        Rope(Rope &&) = default;
+        Rope &operator=(Rope &&) = default;
+
+        // methods
+        void update(float deltaTime);           // moves the links freely, projects them back to the rope and takes their velocities from the motion
+        void projectPositions(float deltaTime); // direct O(n) solves that move the links back to their lengths, at most four, then one pass that sets every length
+        void updateBounds();
+        void draw(sf::RenderTarget &target);
+
+    private:
+        // storage of the solve, sized once in the constructer
+        // the system of a long chain is badly conditioned, so it is solved in double precision
+        std::vector<double> inverseMasses, lower, diagonal, upper, lambdas;
+        std::vector<double> totals; // summed lambdas of the projections of one step
+        std::vector<float> lengths;
+        std::vector<linalg::Vector> directions, startPositions; // positions at the start of the step, the velocities are taken from them
+
+        void assemble();                                // directions, lengths and the matrix of the current positions
+        void solve();                                   // thomas algorithm, lambdas hold the right side and then the solution
+        linalg::Vector constraintImpulse(int link) const; // J^T lambda of one link
+    };
+}
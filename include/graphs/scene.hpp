@@ -0,0 +1,52 @@
+#pragma once
+#include "vector.hpp"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+namespace graphs
+{
+    struct BallSpec
+    {
+        linalg::Vector pos;
+        sf::Color color;
+        float radius, mass, elasticity;
+    };
+
+    struct SoftBodySpec
+    {
+        linalg::Vector center;
+        sf::Color color;
+        int pointCount;
+        float radius, mass, elasticity, springStiffness, pressureStiffness;
+    };
+
+    struct SpringSpec
+    {
+        int ball1, ball2; // indices in balls
+        float normalLength, springCoefficient;
+    };
+
+    struct RopeSpec
+    {
+        linalg::Vector start, end;
+        int linkCount;
+        sf::Color color;
+        float linkRadius, mass, elasticity;
+        bool isPinned;
+    };
+
+    // immutable description of a scene, it can be loaded into the world of any thread
+    class Scene
+    {
+    public:
+        // properties
+        std::vector<BallSpec> balls;
+        std::vector<SoftBodySpec> softBodys;
+        std::vector<SpringSpec> springs;
+        std::vector<RopeSpec> ropes;
+
+        // methods
+        static Scene random(unsigned seed, int numberOfBalls, int numberOfSoftBodys);
+        void load() const; // replaces the balls, springs, soft bodys and ropes of the calling thread
+    };
+}
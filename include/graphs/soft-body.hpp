@@ -8,7 +8,7 @@
 namespace graphs
 {
     class SoftBody;
-    extern std::vector<graphs::SoftBody> SoftBodys;
+    extern thread_local std::vector<graphs::SoftBody> SoftBodys;
 
     class SoftBody
     {
@@ -25,7 +25,7 @@ namespace graphs
         SoftBody(linalg::Vector center, sf::Color color, int pointCount, float radius, float mass, float elasticity, float springStiffness, float pressureStiffness);
 
         void update();
-        void draw(sf::RenderWindow &window);
+        void draw(sf::RenderTarget &target);
         float getCurrentArea() const;
         void computePressureForce();
         void projectileMotion(linalg::Vector &mouseVector, float deltaTime);
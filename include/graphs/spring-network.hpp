@@ -0,0 +1,41 @@
+#pragma once
+#include "vector.hpp"
+#include "scene.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace graphs
+{
+    // builds large networks of balls and springs into a scene in linear time, an edge is added once whatever its direction
+    class SpringNetwork
+    {
+    public:
+        // properties
+        Scene &scene;
+        BallSpec ball;           // color, radius, mass and elasticity of the new balls
+        float springCoefficient; // of the new springs
+
+        // constructer
+        SpringNetwork(Scene &scene, const BallSpec &ball, float springCoefficient);
+
+        // methods
+        void reserve(int ballCount, int springCount);
+        int addBall(const linalg::Vector &pos); // returns the index of the ball in the scene
+        bool addSpring(int ball1, int ball2);   // returns false for an edge that exists, joins a ball to itself or names a ball the scene does not have
+        int addEdges(const std::vector<std::array<int, 2>> &edges); // returns the number of springs added, invalid edges are skipped
+
+        // generators, the indices of their balls start at the end of the scene
+        void addCloth(linalg::Vector origin, int columns, int rows, float spacing, bool hasShearSprings = true);
+        void addLattice(linalg::Vector origin, int columns, int rows, float spacing); // triangular lattice
+        bool addMesh(const std::vector<linalg::Vector> &vertices, const std::vector<std::array<int, 3>> &triangles); // returns false and adds nothing if a triangle names a missing vertex
+        bool importMesh(const std::string &path, linalg::Vector offset, float scale);                                // vertices and faces of an OBJ file, z is dropped, returns false for a file it can not read
+
+    private:
+        std::unordered_set<std::uint64_t> edges;
+
+        static std::uint64_t edgeKey(int ball1, int ball2);
+    };
+}
@@ -12,7 +12,7 @@ namespace graphs
     class SoftBody;
 
     class Spring;
-    extern std::vector<Spring> Springs;
+    extern thread_local std::vector<Spring> Springs;
 
     class Spring
     {
@@ -23,14 +23,14 @@ namespace graphs
         graphs::Ball &ball1, &ball2;
         linalg::Vector springForce;
         sf::Color color;
-        float currentLength, normalLength, springCoefficient;
+        float currentLength, normalLength, springCoefficient, potentialEnergy;
 
-        // construcer
+        // construcer, repeated springs are not detected here, graphs::SpringNetwork removes them while building
         Spring(graphs::SoftBody &body, graphs::Ball &ball1, graphs::Ball &ball2, float normalLength, float springCoefficient, sf::Color color = sf::Color::White);
         Spring(graphs::Ball &ball1, graphs::Ball &ball2, float normalLength, float springCoefficient, sf::Color color = sf::Color::White);
 
         // methods
-        void draw(sf::RenderWindow &window);
+        void draw(sf::RenderTarget &target);
         void computeSpringForce();
     };
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "vector.hpp"
+#include "aabb.hpp"
+#include "ball.hpp"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+namespace graphs
+{
+    class StaticWorld;
+    extern graphs::StaticWorld World;
+
+    // immutable level geometry: the world bounds and static line segments stored in a bounding volume hierarchy
+    class StaticWorld
+    {
+    public:
+        struct Segment
+        {
+            linalg::Vector start, end;
+        };
+
+        struct Node
+        {
+            linalg::AABB box;
+            int right;       // index of the right child, the left child is the next node
+            int first, count; // range of segments for leaf nodes, count is 0 for inner nodes
+        };
+
+        // properties
+        linalg::AABB bounds;
+        std::vector<Segment> segments;
+        std::vector<Node> nodes;
+        sf::VertexArray lines;
+        sf::Color color;
+
+        // constructer
+        StaticWorld(float width, float height, sf::Color color = sf::Color::White);
+
+        // methods, shapes are added before build() and rejected after it, the adds return false then
+        // the queries only read the tree, worlds simulated on other threads share it once it is built
+        bool addSegment(const linalg::Vector &start, const linalg::Vector &end);
+        bool addPolyline(const std::vector<linalg::Vector> &points);
+        bool addConvexPolygon(const std::vector<linalg::Vector> &points);
+        void build();
+        void query(const linalg::AABB &box, std::vector<int> &result) const;
+        void checkBallCollision(graphs::Ball &ball) const;
+        float sweptBallCollision(const graphs::Ball &ball, float deltaTime, int &hitSegment) const; // returns the time of impact as a fraction of deltaTime, greater than 1 if there is none
+        void draw(sf::RenderTarget &target) const;
+
+    private:
+        bool isBuilt; // build() was called, the segments are fixed
+
+        int buildNode(int first, int count);
+        template <typename Visit>
+        void forEachSegment(const linalg::AABB &box, Visit visit) const; // visits the segments of the leaves whose box overlaps the box
+    };
+}
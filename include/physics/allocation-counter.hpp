@@ -0,0 +1,7 @@
+#pragma once
+
+namespace physics{
+    // counts calls of the global operator new, only when the program is compiled with -DPHYSICS_COUNT_ALLOCATIONS
+    bool isCountingAllocations();
+    long long allocationCount(); // allocations since the start of the program, 0 when counting is off
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "../graphs/vector.hpp"
+#include "../graphs/aabb.hpp"
+#include <vector>
+
+namespace physics{
+    // state of a ball sent between the coordinator and the workers
+    struct BallState
+    {
+        float x, y, vx, vy, radius, mass, elasticity;
+        int id; // index in the coordinator's arrays
+        bool isBeingDragged, isTouchWall, isGhost;
+    };
+
+    // state of a soft body, followed by the states of its corner balls
+    struct BodyState
+    {
+        float x, y, radius, mass, elasticity, springStiffness, pressureStiffness;
+        int pointCount, id;
+        bool isBeingDragged, isGhost;
+    };
+
+    // free spring between two balls of the same message
+    struct SpringState
+    {
+        int ball1, ball2;
+        float normalLength, springCoefficient;
+    };
+
+    // vertical strip of the world simulated by one worker process
+    class Domain
+    {
+    public:
+        // properties
+        float minX, maxX, halo;
+
+        // constructer
+        Domain(float minX, float maxX, float halo);
+
+        // methods
+        bool owns(const linalg::Vector &point) const;  // returns true if the point is inside the strip
+        bool touches(const linalg::AABB &box) const;   // returns true if the box reaches the strip or its halo
+    };
+
+    // splits the world into domains, forks a worker process for each of them and exchanges the particles every frame
+    class DomainCoordinator
+    {
+    public:
+        // properties
+        std::vector<Domain> domains;
+        std::vector<int> sockets, workers;
+        void (*stepWorld)(); // step run by the workers on their domain, set before start
+
+        // constructer, the halo has to cover the largest interaction distance plus the motion of one frame
+        DomainCoordinator(int domainCount, float halo);
+        ~DomainCoordinator();
+
+        // methods
+        bool start(); // forks the workers, returns false if processes are not supported
+        bool step();  // advances the world by one frame, returns false if a worker is lost
+        void stop();
+
+    private:
+        std::vector<int> ballOwners, bodyOwners, localIndex;
+        std::vector<char> message;
+
+        void computeOwners();
+        void packDomain(int domain);
+        bool unpackDomain();
+    };
+
+    void runDomainWorker(int socket, void (*stepWorld)()); // receives a frame, simulates it and sends the owned particles back until the socket closes
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../graphs/scene.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace physics{
+    // values that change between the runs of an ensemble
+    struct EnsembleParameters
+    {
+        float elasticity, springStiffness, pressureStiffness, frictionCoefficient, dragCoefficient;
+    };
+
+    // one fixed size record of the output file per run
+    struct EnsembleRecord
+    {
+        std::int32_t run;
+        EnsembleParameters parameters;
+        float kineticEnergy, potentialEnergy, meanX, meanY, maxSpeed, areaError;
+    };
+
+    // runs many independent worlds of the same scene on a pool of threads
+    class Ensemble
+    {
+    public:
+        // properties
+        const graphs::Scene &scene;     // shared by every thread, never changed
+        EnsembleParameters min, max;    // parameters are sampled uniformly between these
+        int runs, frames, threadCount;
+        unsigned seed;
+
+        // constructer
+        Ensemble(const graphs::Scene &scene, int runs, int frames, int threadCount = 0, unsigned seed = 0);
+
+        // methods
+        EnsembleParameters sample(int run) const;
+        EnsembleRecord simulate(int run) const; // loads the scene into the calling thread's world and runs it
+        bool run(const std::string &path) const; // streams one record per run into the file
+    };
+}
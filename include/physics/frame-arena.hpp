@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace physics{
+    // bump allocator for data that lives for one frame, its memory is kept between frames
+    class FrameArena
+    {
+    public:
+        // properties
+        std::size_t capacity, used, highWater; // bytes
+        int blockCount;                         // more than one block means the frame did not fit
+
+        // constructer
+        FrameArena(std::size_t capacity = 1 << 16);
+
+        // methods
+        void *allocate(std::size_t bytes, std::size_t alignment);
+        void reset(); // frees everything, the blocks are merged into one when the frame did not fit
+
+    private:
+        std::vector<std::unique_ptr<std::byte[]>> blocks;
+        std::vector<std::size_t> blockSizes;
+        std::size_t blockUsed; // bytes used in the last block
+
+        friend class ArenaScope;
+    };
+
+    extern thread_local FrameArena frameArena;
+
+    // gives the memory allocated inside a scope back to the arena when the scope ends
+    class ArenaScope
+    {
+    public:
+        ArenaScope(FrameArena &arena = frameArena);
+        ~ArenaScope();
+
+    private:
+        FrameArena &arena;
+        std::size_t used, blockUsed;
+        int blockCount;
+    };
+
+    // allocator for standard containers, deallocation is a no-op
+    template <class T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        FrameArena *arena;
+
+        ArenaAllocator(FrameArena &arena = frameArena) : arena(&arena) {}
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+        T *allocate(std::size_t count) { return static_cast<T *>(this->arena->allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T *, std::size_t) {}
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U> &other) const { return this->arena == other.arena; }
+        template <class U>
+        bool operator!=(const ArenaAllocator<U> &other) const { return this->arena != other.arena; }
+    };
+
+    template <class T>
+    using FrameVector = std::vector<T, ArenaAllocator<T>>;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "../graphs/scene.hpp"
+#include <string>
+#include <vector>
+
+namespace physics{
+    // positions and velocities of every particle at every frame of a seeded scene
+    class Trajectory
+    {
+    public:
+        // properties
+        unsigned seed;
+        int numberOfBalls, numberOfSoftBodys, frames, particleCount;
+        std::vector<float> states; // x, y, vx, vy of the loose balls and then the corner balls, frame after frame
+
+        // constructer
+        Trajectory(unsigned seed = 0, int numberOfBalls = 0, int numberOfSoftBodys = 0);
+
+        // methods
+        void record(int frames, void (*step)()); // loads the seeded scene and runs it with the given step function
+        bool save(const std::string &path) const;
+        bool load(const std::string &path);
+        std::string describeParticle(int particle) const; // "ball 3" or "body 1 corner 7"
+        std::string describeObject(int object) const;     // "ball 3" or "body 1", the bodys follow the loose balls
+    };
+
+    struct Tolerances
+    {
+        float position; // pixels
+        float velocity; // pixels per second
+    };
+
+    struct Divergence
+    {
+        bool hasDiverged;
+        int frame, particle;
+        std::string object, quantity;
+        float error;
+        float maxPositionDrift, rmsPositionDrift; // over the compared frames
+        std::string worstObject;                  // the object with the largest position error over the compared frames
+        int worstFrame;
+        float worstPositionError;
+    };
+
+    Divergence compareTrajectories(const Trajectory &reference, const Trajectory &candidate, const Tolerances &tolerances);
+    // the largest errors of the balls and the body centers over the first horizon frames, the error at the percentile of the objects has to be within the tolerances
+    // for steps whose particles take other paths after the first contacts, the later frames only have to stay finite
+    Divergence compareObjects(const Trajectory &reference, const Trajectory &candidate, const Tolerances &tolerances, int horizon, float percentile);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+namespace physics{
+    enum class MetricsFormat
+    {
+        Prometheus,  // text exposition format, the file is replaced at every sample
+        LineProtocol // one line per sample appended to the file
+    };
+
+    // runtime counters and energy diagnostics of the world of the calling thread
+    class Metrics
+    {
+    public:
+        // counters of the current step, increased by the collision checks
+        long long pairs, contacts, subSteps;
+        long long allocations; // heap allocations of the step, only counted with PHYSICS_COUNT_ALLOCATIONS
+
+        // totals since the start
+        long long frames, totalPairs, totalContacts, totalSubSteps, totalAllocations;
+
+        // sampled values
+        float stepMilliseconds, kineticEnergy, potentialEnergy, springEnergy, areaError;
+
+        // export settings, nothing is written while path is empty
+        std::string path;
+        MetricsFormat format;
+        int sampleInterval;
+        int reductionThreads; // most threads of a reduction, 0 uses the hardware concurrency
+
+        // constructer
+        Metrics();
+
+        // methods
+        void beginStep();
+        void endStep(); // samples and exports every sampleInterval frames
+        void sample();  // computes the energies as parallel reductions
+        bool write() const;
+
+    private:
+        std::chrono::steady_clock::time_point stepStart;
+        long long allocationsAtStart;
+    };
+
+    extern thread_local Metrics metrics;
+}
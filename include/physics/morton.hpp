@@ -0,0 +1,39 @@
+#pragma once
+#include "../graphs/vector.hpp"
+#include "../graphs/aabb.hpp"
+#include "../graphs/ball.hpp"
+#include "../graphs/spring.hpp"
+#include "../graphs/soft-body.hpp"
+#include <utility>
+#include <vector>
+
+namespace physics{
+    unsigned mortonCode(const linalg::Vector &point, const linalg::AABB &bounds); // interleaves 16 bits of x and y inside the bounds
+
+    // keeps graphs::Balls and graphs::SoftBodys sorted along a Z-order curve so that neighbours in space are neighbours in memory
+    class MortonOrder
+    {
+    public:
+        // properties
+        int interval, minInterval, maxInterval; // frames between two locality checks
+        float threshold;                        // share of particles out of order that triggers a reorder
+        float disorder;                         // last measured share of particles out of order
+        int framesSinceCheck, reorderCount;
+
+        // constructer
+        MortonOrder(int minInterval = 30, int maxInterval = 960, float threshold = 0.1f);
+
+        // methods
+        bool update();      // checks the locality when it is due and reorders if needed, returns true after a reorder
+        float measure() const;
+        void reorder();     // references of springs are remapped, indices into the arrays are not valid any more
+
+    private:
+        // storage swapped with the world at every reorder, so its capacity is reused instead of allocated again
+        std::vector<std::pair<unsigned, int>> order;
+        std::vector<int> newIndex;
+        std::vector<graphs::Ball> balls;
+        std::vector<graphs::Spring> springs;
+        std::vector<graphs::SoftBody> bodys;
+    };
+}
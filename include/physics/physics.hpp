@@ -5,9 +5,19 @@ namespace physics{
     extern const float FIXED_DELTA_TIME;
     extern const int SUB_STEPS;
     extern const float SUB_DELTA_TIME;
-    extern const float g;
     extern const float pi;
-    extern const float frictionCoefficient;
-    extern const float dragCoefficient;
-    extern const float airDensity;
+
+    // runtime constants, every thread simulates its own world with its own values
+    extern thread_local float g;
+    extern thread_local float frictionCoefficient;
+    extern thread_local float dragCoefficient;
+    extern thread_local float airDensity;
+
+    // continuous collision detection
+    extern const float CCD_MOTION_THRESHOLD; // a ball is swept when it moves more than this fraction of its radius in one step
+    extern const int CCD_MAX_ITERATIONS;     // maximum number of time of impact sub-steps per step
+    extern const float CCD_CONTACT_SLOP;     // penetration left at the time of impact so the discrete response triggers
+
+    // multi-rate stepping, an island takes from one to SUB_STEPS sub-steps per step
+    extern const float STIFFNESS_STEP; // largest angle a spring of an island may oscillate in one of its sub-steps
 }
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace physics{
+    void step();                  // advances the world by FIXED_DELTA_TIME in SUB_STEPS sub-steps
+    void subStep(float deltaTime); // computes forces, integrates and resolves the collisions once
+    void multiRateStep();          // advances the world by FIXED_DELTA_TIME, every island at the rate its stiffness and speed need
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "../graphs/vector.hpp"
+#include "../graphs/aabb.hpp"
+#include "../graphs/ball.hpp"
+#include "../graphs/spring.hpp"
+#include "../graphs/soft-body.hpp"
+#include "../graphs/rope.hpp"
+#include <vector>
+
+namespace physics{
+    enum class ItemKind
+    {
+        Ball,       // ball of graphs::Balls
+        CornerBall, // corner ball of a soft body
+        Spring,     // spring of graphs::Springs
+        BodySpring, // edge spring of a soft body
+        SoftBody,   // whole soft body, its shape is the circle used for picking
+        RopeLink,   // link ball of a rope
+        RopeSegment // segment between two links of a rope
+    };
+
+    struct SpatialItem
+    {
+        ItemKind kind;
+        int body, index; // body is the soft body or the rope, -1 for loose items
+        linalg::AABB box;
+    };
+
+    struct RayHit
+    {
+        SpatialItem item;
+        float distance;
+        linalg::Vector point;
+    };
+
+    // uniform grid hashed into a fixed table and filled by counting sort, rebuilt from the world of the calling thread
+    class SpatialGrid
+    {
+    public:
+        // properties
+        float cellSize;
+        int tableSize;
+        std::vector<SpatialItem> items;
+        linalg::AABB bounds; // box of all items
+        int particleCount;   // balls, corner balls and rope links among the items
+        float maxSpeed;      // of the fastest ball at the last build, objects moved at most this fast since
+        bool isStale;        // set when the objects moved, the owner rebuilds before the next query
+        std::vector<int> cellStart, cellItems; // items of cell i are cellItems[cellStart[i]] .. cellItems[cellStart[i + 1]]
+
+        // constructer
+        SpatialGrid(float cellSize = 64.f, int tableSize = 4096);
+
+        // methods
+        void build();
+        void queryPoint(const linalg::Vector &point, float tolerance, std::vector<SpatialItem> &result); // items whose shape is within tolerance of the point
+        void queryBox(const linalg::AABB &box, std::vector<SpatialItem> &result);                        // items whose box overlaps the box
+        bool raycast(const linalg::Vector &origin, const linalg::Vector &direction, float maxDistance, RayHit &hit); // closest ball or spring hit by the ray
+        void nearestParticles(const linalg::Vector &point, int count, std::vector<SpatialItem> &result);       // closest balls and corner balls, nearest first
+
+        // accessors of the objects behind an item
+        static graphs::Ball &getBall(const SpatialItem &item);
+        static graphs::Spring &getSpring(const SpatialItem &item);
+        static graphs::SoftBody &getSoftBody(const SpatialItem &item);
+        static bool isBall(ItemKind kind);   // balls, corner balls and rope links
+        static bool isSpring(ItemKind kind); // springs, edge springs and rope segments
+
+    private:
+        std::vector<int> stamps;
+        int stamp;
+
+        void addItem(ItemKind kind, int body, int index, const linalg::AABB &box);
+        int cellIndex(long long x, long long y) const;
+        template <typename Visit>
+        void forEachBucket(const linalg::AABB &box, Visit visit) const; // buckets of the cells under the box, every bucket once for a box over more cells than the table
+        bool nextStamp(int item); // returns true the first time an item is seen by the current query
+        float distanceTo(const SpatialItem &item, const linalg::Vector &point) const;
+    };
+
+    // broadphase of the continuous collision detection, marked stale at every sub-step and rebuilt by the first swept ball
+    extern thread_local SpatialGrid collisionGrid;
+}
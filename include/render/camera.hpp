@@ -0,0 +1,54 @@
+#pragma once
+#include "../graphs/vector.hpp"
+#include "../graphs/aabb.hpp"
+#include "../physics/spatial-grid.hpp"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+namespace render
+{
+    // view of the world that can be panned, zoomed and made to follow a soft body
+    class Camera
+    {
+    public:
+        // properties
+        sf::View view;
+        sf::Vector2f screenSize;
+        float zoom;       // world units per screen pixel
+        int followedBody; // index in graphs::SoftBodys, -1 when free
+
+        // constructer
+        Camera(sf::Vector2f screenSize, linalg::Vector center);
+
+        // methods
+        void pan(const linalg::Vector &offset);               // moves by a world offset
+        void zoomAt(float factor, const linalg::Vector &point); // zooms keeping the world point under the same pixel
+        void follow(int body);
+        void update();                                         // moves to the followed body
+        void reset(const linalg::AABB &area);                  // shows the whole area
+        linalg::AABB visibleArea() const;
+    };
+
+    // draws the objects inside the camera, found with the grid, with cheaper shapes for balls that cover only a few pixels
+    class CulledRenderer
+    {
+    public:
+        // properties
+        float pointRadius;  // balls smaller than this many pixels are drawn as one batched quad
+        float coarseRadius; // balls smaller than this many pixels use a circle with few points
+        int drawnObjects;   // objects submitted in the last frame
+
+        // constructer
+        CulledRenderer(float pointRadius = 1.5f, float coarseRadius = 8.f);
+
+        // methods
+        void draw(sf::RenderTarget &target, physics::SpatialGrid &grid, const Camera &camera);
+
+    private:
+        std::vector<physics::SpatialItem> visibleItems;
+        sf::VertexArray points;
+        sf::CircleShape coarseCircle;
+
+        void drawBall(sf::RenderTarget &target, graphs::Ball &ball, float zoom);
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace render
+{
+    enum class ImageFormat
+    {
+        Png, // compressed, one .png file per frame
+        Raw  // RGBA bytes, one .rgba file per frame
+    };
+
+    // renders the world offscreen and writes an image sequence, encoding runs on a pool of worker threads
+    class FrameRecorder
+    {
+    public:
+        // properties
+        std::string directory;
+        ImageFormat format;
+        sf::Vector2u size;
+        int workerCount;
+        int frameCount;   // frames handed to the encoders
+        int maxQueued;    // rendering waits when this many frames are not encoded yet
+        bool hasFailed;   // an image could not be written
+        double readBackMilliseconds; // spent by the rendering thread copying frames to the CPU, the copy is synchronous
+
+        // constructer
+        FrameRecorder(const std::string &directory, sf::Vector2u size, ImageFormat format = ImageFormat::Png, int workerCount = 0);
+        ~FrameRecorder();
+
+        // methods
+        bool start();                   // creates the render textures and the workers, returns false without a graphics context
+        void record(const sf::View &view); // renders the current world into the next texture
+        void finish();                  // reads back the last frame and waits for the encoders
+
+    private:
+        // the previous frame is read back after the current one is submitted, the GPU has usually finished it by then
+        // the copy still blocks the rendering thread until the pixels arrive, SFML has no asynchronous readback
+        std::array<sf::RenderTexture, 2> textures;
+        int renderedFrames;
+        std::vector<std::thread> workers;
+        std::deque<std::pair<int, sf::Image>> queue;
+        std::mutex queueMutex;
+        std::condition_variable queueChanged;
+        bool isFinished;
+
+        void readBack(int frame);
+        void encode();
+        bool save(int frame, const sf::Image &image) const;
+    };
+}
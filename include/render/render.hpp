@@ -0,0 +1,7 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+namespace render
+{
+    void drawWorld(sf::RenderTarget &target); // draws the static world, the balls, the springs and the soft bodys
+}
@@ -0,0 +1,63 @@
+#include "../../include/graphs/aabb.hpp"
+#include <algorithm>
+
+linalg::AABB::AABB(Vector min, Vector max) : min(min), max(max) {}
+
+// returns the center of the box
+linalg::Vector linalg::AABB::center() const
+{
+    return (this->min + this->max) / 2.f;
+}
+
+// returns the width and height of the box
+linalg::Vector linalg::AABB::size() const
+{
+    return this->max - this->min;
+}
+
+// returns true if the point is inside the box
+bool linalg::AABB::contains(const Vector &point) const
+{
+    return point.x >= this->min.x && point.x <= this->max.x &&
+           point.y >= this->min.y && point.y <= this->max.y;
+}
+
+// returns true if two boxes overlap
+bool linalg::AABB::overlaps(const AABB &box) const
+{
+    return this->min.x <= box.max.x && this->max.x >= box.min.x &&
+           this->min.y <= box.max.y && this->max.y >= box.min.y;
+}
+
+// returns the box that covers both boxes
+linalg::AABB linalg::AABB::merge(const AABB &box) const
+{
+    return AABB(Vector(std::min(this->min.x, box.min.x), std::min(this->min.y, box.min.y)),
+                Vector(std::max(this->max.x, box.max.x), std::max(this->max.y, box.max.y)));
+}
+
+// returns the box both boxes cover, only valid if they overlap
+linalg::AABB linalg::AABB::intersect(const AABB &box) const
+{
+    return AABB(Vector(std::max(this->min.x, box.min.x), std::max(this->min.y, box.min.y)),
+                Vector(std::min(this->max.x, box.max.x), std::min(this->max.y, box.max.y)));
+}
+
+// returns the box grown by margin on every side
+linalg::AABB linalg::AABB::expand(float margin) const
+{
+    return AABB(this->min - Vector(margin, margin), this->max + Vector(margin, margin));
+}
+
+// returns the box of a line segment
+linalg::AABB linalg::AABB::fromSegment(const Vector &start, const Vector &end)
+{
+    return AABB(Vector(std::min(start.x, end.x), std::min(start.y, end.y)),
+                Vector(std::max(start.x, end.x), std::max(start.y, end.y)));
+}
+
+// returns the box of a circle
+linalg::AABB linalg::AABB::fromCircle(const Vector &center, float radius)
+{
+    return AABB(center - Vector(radius, radius), center + Vector(radius, radius));
+}
@@ -1,14 +1,23 @@
 #include "../../include/graphs/ball.hpp"
 #include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include "../../include/graphs/rope.hpp"
 #include "../../include/physics/physics.hpp"
+#include "../../include/physics/metrics.hpp"
+#include "../../include/physics/spatial-grid.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
+thread_local std::vector<graphs::Ball> graphs::Balls;
+
 graphs::Ball::Ball(linalg::Vector pos, sf::Color color, float radius, float mass, float elasticity)
     : color(color),
       radius(radius),
       mass(mass),
       elasticity(elasticity),
+      stepTime(0.f),
       prevPos(0.f, 0.f),
       pos(pos),
       vel(0.f, 0.f),
@@ -43,12 +52,13 @@ void graphs::Ball::update(float deltaTime)
     this->acc = this->force / this->mass;
     this->vel = this->vel + this->acc * deltaTime;
     this->pos = this->pos + this->vel * deltaTime;
+    this->stepTime = deltaTime;
 }
 
-void graphs::Ball::draw(sf::RenderWindow &window)
+void graphs::Ball::draw(sf::RenderTarget &target)
 {
     this->shape.setPosition({this->pos.x, this->pos.y});
-    window.draw(this->shape);
+    target.draw(this->shape);
 }
 
 void graphs::Ball::computeDragForce()
@@ -108,9 +118,11 @@ void graphs::Ball::checkBallCollision(graphs::Ball &ball)
     linalg::Vector axis(this->pos - ball.pos);
     float distance = axis.magnitude();
     float overlap = this->radius + ball.radius - distance;
+    physics::metrics.pairs++;
 
     if (overlap > 0)
     {
+        physics::metrics.contacts++;
         linalg::Vector normalVector(axis.unit());
         linalg::Vector relativeVel(this->vel - ball.vel);
         const float elasticityCoefficient = (this->elasticity + ball.elasticity) / 2;
@@ -134,33 +146,41 @@ void graphs::Ball::checkBallCollision(graphs::Ball &ball)
 
 void graphs::Ball::checkSpringCollision(graphs::Spring &spring)
 {
-    if (&*this == &spring.ball1 || &*this == &spring.ball2)
+    this->checkEdgeCollision(spring.ball1, spring.ball2);
+}
+
+// the edge gets the reaction at the contact point, shared by its balls
+void graphs::Ball::checkEdgeCollision(graphs::Ball &start, graphs::Ball &end)
+{
+    if (&*this == &start || &*this == &end)
     {
         return;
     }
 
-    linalg::Vector springVector = spring.ball2.pos - spring.ball1.pos;
-    linalg::Vector ballToStart = this->pos - spring.ball1.pos;
-    linalg::Vector ballToEnd = this->pos - spring.ball2.pos;
+    physics::metrics.pairs++;
 
-    float springLength = springVector.magnitude();
+    linalg::Vector edgeVector = end.pos - start.pos;
+    linalg::Vector ballToStart = this->pos - start.pos;
+    linalg::Vector ballToEnd = this->pos - end.pos;
+
+    float edgeLength = edgeVector.magnitude();
     linalg::Vector closestVector;
     float projection;
 
-    linalg::Vector springUnit = springVector / springLength;
-    projection = ballToStart.dot(springUnit);
+    linalg::Vector edgeUnit = edgeVector / edgeLength;
+    projection = ballToStart.dot(edgeUnit);
 
     if (projection < 0.0f)
     {
         closestVector = ballToStart;
     }
-    else if (projection > springLength)
+    else if (projection > edgeLength)
     {
         closestVector = ballToEnd;
     }
     else
     {
-        linalg::Vector projectionvector = springUnit * projection;
+        linalg::Vector projectionvector = edgeUnit * projection;
         closestVector = ballToStart - projectionvector;
     }
 
@@ -174,76 +194,333 @@ void graphs::Ball::checkSpringCollision(graphs::Spring &spring)
         float fractionB = 0.0f;
         float fractionA = 1.0f;
 
-        if (projection > 0.0f && projection < springLength)
+        if (projection > 0.0f && projection < edgeLength)
         {
-            fractionB = projection / springLength;
+            fractionB = projection / edgeLength;
             fractionA = 1.0f - fractionB;
         }
-        else if (projection >= springLength)
+        else if (projection >= edgeLength)
         {
             fractionB = 1.0f;
             fractionA = 0.0f;
         }
 
-        linalg::Vector velOfContactPoint = (spring.ball1.vel * fractionA) + (spring.ball2.vel * fractionB);
+        linalg::Vector velOfContactPoint = (start.vel * fractionA) + (end.vel * fractionB);
 
         linalg::Vector relativeVel = this->vel - velOfContactPoint;
         float velNormal = relativeVel.dot(normal);
 
         if (velNormal < 0.0f)
         {
+            physics::metrics.contacts++;
+
             float invMassThis = 1.0f / this->mass;
-            float invMassB1 = (spring.ball1.mass > 1e-6f) ? 1.0f / spring.ball1.mass : 0.0f;
-            float invMassB2 = (spring.ball2.mass > 1e-6f) ? 1.0f / spring.ball2.mass : 0.0f;
+            float invMassB1 = (start.mass > 1e-6f) ? 1.0f / start.mass : 0.0f;
+            float invMassB2 = (end.mass > 1e-6f) ? 1.0f / end.mass : 0.0f;
 
             float totalInvMass = invMassThis + invMassB1 + invMassB2;
 
             this->pos = this->pos + normal * (overlap * (invMassThis / totalInvMass));
-            spring.ball1.pos = spring.ball1.pos - normal * (overlap * (invMassB1 / totalInvMass));
-            spring.ball2.pos = spring.ball2.pos - normal * (overlap * (invMassB2 / totalInvMass));
+            start.pos = start.pos - normal * (overlap * (invMassB1 / totalInvMass));
+            end.pos = end.pos - normal * (overlap * (invMassB2 / totalInvMass));
 
-            float invMassEffectiveSpring = (fractionA * fractionA * invMassB1) + (fractionB * fractionB * invMassB2);
+            float invMassEffectiveEdge = (fractionA * fractionA * invMassB1) + (fractionB * fractionB * invMassB2);
 
             float elasticity = this->elasticity;
-            float impulseMagnitude = -(1.0f + elasticity) * velNormal / (invMassThis + invMassEffectiveSpring);
+            float impulseMagnitude = -(1.0f + elasticity) * velNormal / (invMassThis + invMassEffectiveEdge);
 
             linalg::Vector impulseVector = normal * impulseMagnitude;
 
             this->vel = this->vel + impulseVector * invMassThis;
 
             linalg::Vector reactionImpulse = impulseVector * -1.0f;
-            spring.ball1.vel = spring.ball1.vel + (reactionImpulse * fractionA) * invMassB1;
-            spring.ball2.vel = spring.ball2.vel + (reactionImpulse * fractionB) * invMassB2;
+            start.vel = start.vel + (reactionImpulse * fractionA) * invMassB1;
+            end.vel = end.vel + (reactionImpulse * fractionB) * invMassB2;
         }
     }
 }
 
-// void graphs::Ball::checks
+// checks a static segment, it does not move and has infinite mass
+void graphs::Ball::checkSegmentCollision(const linalg::Vector &start, const linalg::Vector &end)
+{
+    linalg::Vector segmentVector = end - start;
+    float segmentLengthSquared = segmentVector.dot(segmentVector);
+
+    float projection = 0.f;
+    if (segmentLengthSquared > 0.f)
+    {
+        projection = std::clamp((this->pos - start).dot(segmentVector) / segmentLengthSquared, 0.f, 1.f);
+    }
+
+    linalg::Vector closestVector = this->pos - (start + segmentVector * projection);
+    float closestDistance = closestVector.magnitude();
+    float overlap = this->radius - closestDistance;
+    physics::metrics.pairs++;
+
+    if (overlap > 0)
+    {
+        physics::metrics.contacts++;
+        linalg::Vector normal = (closestDistance > 0.f) ? closestVector / closestDistance : linalg::Vector(-segmentVector.y, segmentVector.x).unit();
+
+        this->pos = this->pos + normal * overlap;
+
+        float velNormal = this->vel.dot(normal);
+        if (velNormal < 0.f)
+        {
+            this->vel = this->vel - normal * ((1.f + this->elasticity) * velNormal);
+        }
+        this->isTouchWall = true;
+    }
+}
+
+// checks the bounds of the world and the static geometry
 void graphs::Ball::checkWallCollision()
 {
+    const linalg::AABB &bounds = graphs::World.bounds;
 
-    if (this->pos.y + this->radius >= 900) // bottom wall
+    if (this->pos.y + this->radius >= bounds.max.y) // bottom wall
     {
-        this->pos.y = 900 - this->radius;
+        this->pos.y = bounds.max.y - this->radius;
         this->vel.y *= -this->elasticity;
         this->isTouchWall = true;
     }
-    if (this->pos.y - this->radius <= 0) // top wall
+    if (this->pos.y - this->radius <= bounds.min.y) // top wall
     {
-        this->pos.y = 0 + this->radius;
+        this->pos.y = bounds.min.y + this->radius;
         this->vel.y *= -this->elasticity;
         this->isTouchWall = true;
     }
-    if (this->pos.x + this->radius >= 1200) // right wall
+    if (this->pos.x + this->radius >= bounds.max.x) // right wall
     {
-        this->pos.x = 1200 - this->radius;
+        this->pos.x = bounds.max.x - this->radius;
         this->vel.x *= -this->elasticity;
         this->isTouchWall = true;
     }
-    if (this->pos.x - this->radius <= 0) // left wall
+    if (this->pos.x - this->radius <= bounds.min.x) // left wall
     {
-        this->pos.x = 0 + this->radius;
+        this->pos.x = bounds.min.x + this->radius;
         this->vel.x *= -this->elasticity;
         this->isTouchWall = true;
     }
-}
\ No newline at end of file
+
+    graphs::World.checkBallCollision(*this);
+}
+
+// returns the first time in [0, 1] that a point moving along motion reaches the circle, 2 if it never does
+static float sweptPointCircle(const linalg::Vector &start, const linalg::Vector &motion, const linalg::Vector &center, float radius)
+{
+    linalg::Vector offset = start - center;
+    float c = offset.dot(offset) - radius * radius;
+    float b = offset.dot(motion);
+
+    // already touching or moving away, the discrete checks handle it
+    if (c <= 0.f || b >= 0.f)
+    {
+        return 2.f;
+    }
+
+    float a = motion.dot(motion);
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.f)
+    {
+        return 2.f;
+    }
+
+    float time = (-b - std::sqrt(discriminant)) / a;
+    return (time <= 1.f) ? time : 2.f;
+}
+
+// returns the first time in [0, 1] that a point moving along motion reaches the capsule around the segment, 2 if it never does
+static float sweptPointSegment(const linalg::Vector &start, const linalg::Vector &motion, const linalg::Vector &segmentStart, const linalg::Vector &segmentEnd, float radius)
+{
+    linalg::Vector segmentVector = segmentEnd - segmentStart;
+    float segmentLength = segmentVector.magnitude();
+    if (segmentLength == 0.f)
+    {
+        return sweptPointCircle(start, motion, segmentStart, radius);
+    }
+
+    linalg::Vector segmentUnit = segmentVector / segmentLength;
+    linalg::Vector normal(-segmentUnit.y, segmentUnit.x);
+
+    float time = 2.f;
+
+    // side of the capsule
+    float distance = (start - segmentStart).dot(normal);
+    float side = (distance > 0.f) ? 1.f : -1.f;
+    float approach = motion.dot(normal) * side;
+
+    if (distance * side > radius && approach < 0.f)
+    {
+        float sideTime = (distance * side - radius) / -approach;
+        if (sideTime <= 1.f)
+        {
+            float projection = (start + motion * sideTime - segmentStart).dot(segmentUnit);
+            if (projection >= 0.f && projection <= segmentLength)
+            {
+                time = sideTime;
+            }
+        }
+    }
+
+    // rounded ends of the capsule
+    time = std::min(time, sweptPointCircle(start, motion, segmentStart, radius));
+    time = std::min(time, sweptPointCircle(start, motion, segmentEnd, radius));
+
+    return time;
+}
+
+bool graphs::Ball::isFastMover(float deltaTime) const
+{
+    return this->vel.magnitude() * deltaTime > this->radius * physics::CCD_MOTION_THRESHOLD;
+}
+
+linalg::Vector graphs::Ball::positionAt(float time) const
+{
+    return this->pos + this->vel * (time - this->stepTime);
+}
+
+float graphs::Ball::sweptBallCollision(const graphs::Ball &ball, float deltaTime, float elapsedTime) const
+{
+    // sweeps the relative motion, leaving a small penetration so checkBallCollision responds at the time of impact
+    float contactSlop = std::min(physics::CCD_CONTACT_SLOP, std::min(this->radius, ball.radius) * 0.5f);
+    linalg::Vector motion = (this->vel - ball.vel) * deltaTime;
+
+    return sweptPointCircle(this->pos, motion, ball.positionAt(elapsedTime), this->radius + ball.radius - contactSlop);
+}
+
+float graphs::Ball::sweptSegmentCollision(const linalg::Vector &start, const linalg::Vector &end, const linalg::Vector &segmentVel, float deltaTime) const
+{
+    float contactSlop = std::min(physics::CCD_CONTACT_SLOP, this->radius * 0.5f);
+    linalg::Vector motion = (this->vel - segmentVel) * deltaTime;
+
+    return sweptPointSegment(this->pos, motion, start, end, this->radius - contactSlop);
+}
+
+float graphs::Ball::sweptSpringCollision(const graphs::Spring &spring, float deltaTime, float elapsedTime) const
+{
+    if (this == &spring.ball1 || this == &spring.ball2)
+    {
+        return 2.f;
+    }
+
+    // the spring is swept with the mean velocity of its ends
+    linalg::Vector springVel = (spring.ball1.vel + spring.ball2.vel) / 2.f;
+
+    return this->sweptSegmentCollision(spring.ball1.positionAt(elapsedTime), spring.ball2.positionAt(elapsedTime), springVel, deltaTime);
+}
+
+// candidates of the swept balls, reused by every sweep of the thread
+static thread_local std::vector<physics::SpatialItem> sweepCandidates;
+
+void graphs::Ball::sweptUpdate(float deltaTime, const graphs::SoftBody *ignoredBody)
+{
+    if (this->isBeingDragged)
+    {
+        return;
+    }
+
+    this->force = this->gravity + this->dragForce + this->frictionForce + this->springForce + this->pressureForce;
+    this->acc = this->force / this->mass;
+    this->vel = this->vel + this->acc * deltaTime;
+
+    // the other objects are only near the sweep, they moved by at most maxSpeed since the grid was built and move as much again in the step
+    physics::SpatialGrid &grid = physics::collisionGrid;
+    if (grid.isStale)
+    {
+        grid.build();
+    }
+    int ignoredIndex = (ignoredBody != nullptr) ? static_cast<int>(ignoredBody - graphs::SoftBodys.data()) : -1;
+
+    // moves to the earliest time of impact, resolves it and sweeps the rest of the step
+    float elapsedTime = 0.f;
+    float remainingTime = deltaTime;
+    for (int iteration = 0; iteration < physics::CCD_MAX_ITERATIONS && remainingTime > 0.f; iteration++)
+    {
+        graphs::Ball *hitBall = nullptr;
+        graphs::Spring *hitSpring = nullptr;
+        int hitSegment = -1;
+        float earliestTime = graphs::World.sweptBallCollision(*this, remainingTime, hitSegment);
+
+        float margin = 2.f * grid.maxSpeed * deltaTime;
+        linalg::AABB sweepBox = linalg::AABB::fromSegment(this->pos, this->pos + this->vel * remainingTime).expand(this->radius + margin);
+        sweepCandidates.clear();
+        if (sweepBox.overlaps(grid.bounds.expand(margin)))
+        {
+            // nothing is further out than the items were at the build
+            grid.queryBox(sweepBox.intersect(grid.bounds.expand(margin)), sweepCandidates);
+        }
+
+        for (const physics::SpatialItem &item : sweepCandidates)
+        {
+            // rope links are covered by the capsules of their segments
+            if (item.kind == physics::ItemKind::SoftBody || item.kind == physics::ItemKind::RopeLink || (item.body == ignoredIndex && (item.kind == physics::ItemKind::CornerBall || item.kind == physics::ItemKind::BodySpring)))
+            {
+                continue;
+            }
+
+            if (physics::SpatialGrid::isBall(item.kind))
+            {
+                graphs::Ball &ball = physics::SpatialGrid::getBall(item);
+                if (&ball == this)
+                {
+                    continue;
+                }
+                float time = this->sweptBallCollision(ball, remainingTime, elapsedTime);
+                if (time < earliestTime)
+                {
+                    earliestTime = time;
+                    hitBall = &ball;
+                    hitSpring = nullptr;
+                    hitSegment = -1;
+                }
+            }
+            else
+            {
+                graphs::Spring &spring = physics::SpatialGrid::getSpring(item);
+                float time = this->sweptSpringCollision(spring, remainingTime, elapsedTime);
+                if (time < earliestTime)
+                {
+                    earliestTime = time;
+                    hitBall = nullptr;
+                    hitSpring = &spring;
+                    hitSegment = -1;
+                }
+            }
+        }
+
+        if (earliestTime > 1.f)
+        {
+            break;
+        }
+
+        this->pos = this->pos + this->vel * (remainingTime * earliestTime);
+        elapsedTime = elapsedTime + remainingTime * earliestTime;
+        remainingTime = remainingTime * (1.f - earliestTime);
+
+        // the target is moved to where the sweep met it for the response, the balls that already integrated their step are at its end
+        // it goes on from there with the velocity of the response, back to the time of the sub-step it had reached
+        if (hitSegment != -1)
+        {
+            const graphs::StaticWorld::Segment &segment = graphs::World.segments[hitSegment];
+            this->checkSegmentCollision(segment.start, segment.end);
+        }
+        else if (hitBall != nullptr)
+        {
+            hitBall->pos = hitBall->positionAt(elapsedTime);
+            this->checkBallCollision(*hitBall);
+            hitBall->pos = hitBall->pos + hitBall->vel * (hitBall->stepTime - elapsedTime);
+        }
+        else
+        {
+            hitSpring->ball1.pos = hitSpring->ball1.positionAt(elapsedTime);
+            hitSpring->ball2.pos = hitSpring->ball2.positionAt(elapsedTime);
+            this->checkSpringCollision(*hitSpring);
+            hitSpring->ball1.pos = hitSpring->ball1.pos + hitSpring->ball1.vel * (hitSpring->ball1.stepTime - elapsedTime);
+            hitSpring->ball2.pos = hitSpring->ball2.pos + hitSpring->ball2.vel * (hitSpring->ball2.stepTime - elapsedTime);
+        }
+    }
+
+    this->pos = this->pos + this->vel * remainingTime;
+    this->stepTime = deltaTime;
+}
@@ -0,0 +1,260 @@
+#include "../../include/graphs/rope.hpp"
+#include <algorithm>
+#include <cmath>
+
+thread_local std::vector<graphs::Rope> graphs::Ropes;
+
+// the projection is repeated until every link is this close to its length, relative to the length
+static const float LENGTH_TOLERANCE = 1e-3f;
+
+// limit of the projections in one sub-step, a hanging rope needs one or two whatever its length
+static const int MAX_PROJECTIONS = 4;
+
+// part of the last pass of a link given back by the link before it, without it the pass would pull the mass of the rope towards its first link
+static const float FOLLOW_DAMPING = 0.9f;
+
+graphs::Rope::Rope(linalg::Vector start, linalg::Vector end, int linkCount, sf::Color color, float linkRadius, float mass, float elasticity, bool isPinned)
+    : anchor(start),
+      color(color),
+      linkLength((end - start).magnitude() / std::max(1, linkCount - 1)),
+      tension(0.f),
+      mass(mass),
+      elasticity(elasticity),
+      isPinned(isPinned)
+{
+    // segments hold references to the links, so the links never reallocate
+    this->links.reserve(linkCount);
+    this->segments.reserve(std::max(0, linkCount - 1));
+
+    for (int i = 0; i < linkCount; i++)
+    {
+        float fraction = (linkCount > 1) ? static_cast<float>(i) / (linkCount - 1) : 0.f;
+        this->links.emplace_back(start + (end - start) * fraction, this->color, linkRadius, this->mass / linkCount, this->elasticity);
+    }
+    for (int i = 0; i + 1 < linkCount; i++)
+    {
+        this->segments.emplace_back(this->links[i], this->links[i + 1], this->linkLength, 0.f, this->color);
+    }
+
+    int constraintCount = this->segments.size();
+    this->inverseMasses.resize(linkCount);
+    this->directions.resize(constraintCount);
+    this->lengths.resize(constraintCount);
+    this->startPositions.resize(linkCount);
+    this->lower.resize(constraintCount);
+    this->diagonal.resize(constraintCount);
+    this->upper.resize(constraintCount);
+    this->lambdas.resize(constraintCount);
+    this->totals.resize(constraintCount);
+
+    this->updateBounds();
+}
+
+void graphs::Rope::update(float deltaTime)
+{
+    for (graphs::Ball &link : this->links)
+    {
+        link.computeDragForce();
+        link.computeFrictionForce();
+        link.checkWallCollision();
+    }
+    if (this->segments.empty())
+    {
+        for (graphs::Ball &link : this->links)
+        {
+            link.update(deltaTime);
+        }
+        this->updateBounds();
+        return;
+    }
+
+    // the pinned link stays at its anchor, it and the dragged links have infinite mass
+    if (this->isPinned)
+    {
+        this->links[0].pos = this->anchor;
+        this->links[0].vel = linalg::Vector(0.f, 0.f);
+    }
+    double freeEnergy = 0.0;
+    for (int i = 0; i < this->links.size(); i++)
+    {
+        graphs::Ball &link = this->links[i];
+        bool isFixed = (i == 0 && this->isPinned) || link.isBeingDragged;
+        this->inverseMasses[i] = isFixed ? 0.0 : 1.0 / link.mass;
+
+        // every link moves freely first and the projection takes it back to the rope
+        this->startPositions[i] = link.pos;
+        if (!isFixed)
+        {
+            link.update(deltaTime);
+            freeEnergy += 0.5 * link.mass * link.vel.dot(link.vel);
+        }
+    }
+    this->projectPositions(deltaTime);
+
+    // the links leave the step with the velocity of the motion they made
+    double energy = 0.0;
+    for (int i = 0; i < this->links.size(); i++)
+    {
+        graphs::Ball &link = this->links[i];
+        if (this->inverseMasses[i] != 0.0)
+        {
+            link.vel = (link.pos - this->startPositions[i]) / deltaTime;
+            energy += 0.5 * link.mass * link.vel.dot(link.vel);
+        }
+    }
+
+    // the links do no work, a link that crossed its neighbours in the step can make the projection find a faster rope and that energy is taken back
+    if (energy > freeEnergy)
+    {
+        float scale = static_cast<float>(std::sqrt(freeEnergy / energy));
+        for (int i = 0; i < this->links.size(); i++)
+        {
+            if (this->inverseMasses[i] != 0.0)
+            {
+                this->links[i].vel = this->links[i].vel * scale;
+            }
+        }
+    }
+    this->updateBounds();
+}
+
+void graphs::Rope::projectPositions(float deltaTime)
+{
+    // every solve is linear in the directions of the links, it is repeated from the positions it reached while a link turned too far for one
+    // the velocities are taken from the motion after it, so the turns of the links travel along the rope without a limit on the step
+    std::fill(this->totals.begin(), this->totals.end(), 0.0);
+    for (int projection = 0; projection < MAX_PROJECTIONS; projection++)
+    {
+        this->assemble();
+        float error = 0.f;
+        for (int i = 0; i < this->segments.size(); i++)
+        {
+            this->lambdas[i] = this->linkLength - this->lengths[i];
+            error = std::max(error, std::abs(this->linkLength - this->lengths[i]));
+        }
+        if (error <= LENGTH_TOLERANCE * this->linkLength)
+        {
+            break;
+        }
+        this->solve();
+
+        for (int i = 0; i < this->segments.size(); i++)
+        {
+            this->totals[i] += this->lambdas[i];
+        }
+        for (int i = 0; i < this->links.size(); i++)
+        {
+            graphs::Ball &link = this->links[i];
+            link.pos = link.pos + this->constraintImpulse(i) * static_cast<float>(this->inverseMasses[i]);
+        }
+    }
+
+    // a link that turned too far for the projections keeps some error, every link is put back at its length from the one before it
+    for (int i = 1; i < this->links.size(); i++)
+    {
+        graphs::Ball &link = this->links[i];
+        linalg::Vector axis = link.pos - this->links[i - 1].pos;
+        float length = axis.magnitude();
+        if (this->inverseMasses[i] == 0.0 || length == 0.f)
+        {
+            continue;
+        }
+        linalg::Vector move = axis * (this->linkLength / length) - axis;
+        link.pos = link.pos + move;
+        this->startPositions[i - 1] = this->startPositions[i - 1] + move * FOLLOW_DAMPING;
+    }
+
+    // a projection moves mass times length, the force that made it over the step is that over the squared step
+    this->tension = 0.f;
+    for (double total : this->totals)
+    {
+        this->tension = std::max(this->tension, static_cast<float>(std::abs(total) / (deltaTime * deltaTime)));
+    }
+}
+
+void graphs::Rope::assemble()
+{
+    int count = this->segments.size();
+
+    // constraint i keeps links i and i + 1 at linkLength, J M^-1 J^T is tridiagonal along the chain
+    for (int i = 0; i < count; i++)
+    {
+        linalg::Vector axis = this->links[i + 1].pos - this->links[i].pos;
+        this->lengths[i] = axis.magnitude();
+        this->directions[i] = (this->lengths[i] > 0.f) ? axis / this->lengths[i] : linalg::Vector(0.f, 0.f);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        this->diagonal[i] = this->inverseMasses[i] + this->inverseMasses[i + 1];
+        this->lower[i] = (i > 0) ? -this->inverseMasses[i] * this->directions[i - 1].dot(this->directions[i]) : 0.0;
+        this->upper[i] = (i + 1 < count) ? -this->inverseMasses[i + 1] * this->directions[i].dot(this->directions[i + 1]) : 0.0;
+    }
+}
+
+void graphs::Rope::solve()
+{
+    int count = this->segments.size();
+
+    // thomas algorithm, upper becomes the eliminated coefficients and lambdas the eliminated right side
+    for (int i = 0; i < count; i++)
+    {
+        double denominator = this->diagonal[i] - ((i > 0) ? this->lower[i] * this->upper[i - 1] : 0.0);
+        if (std::abs(denominator) < 1e-12)
+        {
+            // both links are fixed, the constraint can not move them
+            this->upper[i] = 0.0;
+            this->lambdas[i] = 0.0;
+            continue;
+        }
+        this->upper[i] = this->upper[i] / denominator;
+        this->lambdas[i] = (this->lambdas[i] - ((i > 0) ? this->lower[i] * this->lambdas[i - 1] : 0.0)) / denominator;
+    }
+    for (int i = count - 2; i >= 0; i--)
+    {
+        this->lambdas[i] = this->lambdas[i] - this->upper[i] * this->lambdas[i + 1];
+    }
+}
+
+linalg::Vector graphs::Rope::constraintImpulse(int link) const
+{
+    linalg::Vector impulse(0.f, 0.f);
+    if (this->inverseMasses[link] == 0.0)
+    {
+        return impulse;
+    }
+    if (link > 0)
+    {
+        impulse = impulse + this->directions[link - 1] * static_cast<float>(this->lambdas[link - 1]);
+    }
+    if (link < this->segments.size())
+    {
+        impulse = impulse - this->directions[link] * static_cast<float>(this->lambdas[link]);
+    }
+    return impulse;
+}
+
+void graphs::Rope::updateBounds()
+{
+    if (this->links.empty())
+    {
+        return;
+    }
+
+    this->bounds = linalg::AABB::fromCircle(this->links[0].pos, this->links[0].radius);
+    for (const graphs::Ball &link : this->links)
+    {
+        this->bounds = this->bounds.merge(linalg::AABB::fromCircle(link.pos, link.radius));
+    }
+}
+
+void graphs::Rope::draw(sf::RenderTarget &target)
+{
+    for (graphs::Spring &segment : this->segments)
+    {
+        segment.draw(target);
+    }
+    for (graphs::Ball &link : this->links)
+    {
+        link.draw(target);
+    }
+}
@@ -0,0 +1,88 @@
+#include "../../include/graphs/scene.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/rope.hpp"
+#include <random>
+
+// creates random number
+static float getRandomNumber(std::mt19937 &gen, float min, float max)
+{
+    std::uniform_real_distribution<> distrib(min, max);
+
+    return distrib(gen);
+}
+
+graphs::Scene graphs::Scene::random(unsigned seed, int numberOfBalls, int numberOfSoftBodys)
+{
+    std::mt19937 gen(seed);
+    Scene scene;
+
+    // creates random balls
+    for (int i = 0; i < numberOfBalls; i++)
+    {
+        float red = getRandomNumber(gen, 0.f, 255.f);   // red
+        float green = getRandomNumber(gen, 0.f, 255.f); // green
+        float blue = getRandomNumber(gen, 0.f, 255.f);  // blue
+        float x = getRandomNumber(gen, 0.f, 1200.f);    // x position
+        float y = getRandomNumber(gen, 0.f, 900.f);     // y position
+        float r = getRandomNumber(gen, 30.f, 50.f);     // radius
+        float m = getRandomNumber(gen, 10.f, 20.f);     // mass
+        float e = getRandomNumber(gen, 0.1f, 0.6f);     // elasticity
+
+        scene.balls.push_back({linalg::Vector(x, y), sf::Color(red, green, blue), r, m, e});
+    }
+
+    // creates random bodys
+    for (int i = 0; i < numberOfSoftBodys; i++)
+    {
+        float red = getRandomNumber(gen, 0.f, 255.f);   // red
+        float green = getRandomNumber(gen, 0.f, 255.f); // green
+        float blue = getRandomNumber(gen, 0.f, 255.f);  // blue
+        float x = getRandomNumber(gen, 0.f, 1200.f);    // x position
+        float y = getRandomNumber(gen, 0.f, 900.f);     // y position
+        float r = getRandomNumber(gen, 50.f, 70.f);     // radius
+        float m = getRandomNumber(gen, 10.f, 20.f);     // mass
+        float e = getRandomNumber(gen, 0.1f, 0.5f);     // elasticity
+        float s = getRandomNumber(gen, 0.1f, 0.8f);     // spring stiffness
+        float p = getRandomNumber(gen, 0.f, 0.05f);     // pressure stiffness
+
+        scene.softBodys.push_back({linalg::Vector(x, y), sf::Color(red, green, blue), 25, r, m, e, s, p});
+    }
+
+    if (numberOfBalls >= 2)
+    {
+        scene.springs.push_back({0, 1, 200.f, 0.5f});
+    }
+
+    return scene;
+}
+
+void graphs::Scene::load() const
+{
+    // springs keep references to the balls, so the storage is reserved before anything is created
+    graphs::Springs.clear();
+    graphs::Ropes.clear();
+    graphs::SoftBodys.clear();
+    graphs::Balls.clear();
+    graphs::Balls.reserve(this->balls.size());
+    graphs::Springs.reserve(this->springs.size());
+    graphs::SoftBodys.reserve(this->softBodys.size());
+    graphs::Ropes.reserve(this->ropes.size());
+
+    for (const BallSpec &ball : this->balls)
+    {
+        graphs::Balls.emplace_back(ball.pos, ball.color, ball.radius, ball.mass, ball.elasticity); // position, color, radius, mass, elasticity
+    }
+    for (const SoftBodySpec &body : this->softBodys)
+    {
+        graphs::SoftBodys.emplace_back(body.center, body.color, body.pointCount, body.radius, body.mass, body.elasticity, body.springStiffness, body.pressureStiffness);
+    }
+    for (const SpringSpec &spring : this->springs)
+    {
+        graphs::Springs.emplace_back(graphs::Balls.at(spring.ball1), graphs::Balls.at(spring.ball2), spring.normalLength, spring.springCoefficient);
+    }
+    for (const RopeSpec &rope : this->ropes)
+    {
+        graphs::Ropes.emplace_back(rope.start, rope.end, rope.linkCount, rope.color, rope.linkRadius, rope.mass, rope.elasticity, rope.isPinned);
+    }
+}
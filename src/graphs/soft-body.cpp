@@ -2,6 +2,8 @@
 #include "../../include/physics/physics.hpp"
 #include <cmath>
 
+thread_local std::vector<graphs::SoftBody> graphs::SoftBodys;
+
 graphs::SoftBody::SoftBody(linalg::Vector center, sf::Color color, int pointCount, float radius, float mass, float elasticity, float springStiffness, float pressureStiffness)
     : center(center),
       prevPos(0.f, 0.f),
@@ -68,8 +70,8 @@ void graphs::SoftBody::update()
     }
 }
 
-void graphs::SoftBody::draw(sf::RenderWindow &window){
-    window.draw(this->body);
+void graphs::SoftBody::draw(sf::RenderTarget &target){
+    target.draw(this->body);
 }
 
 float graphs::SoftBody::getCurrentArea() const
@@ -0,0 +1,245 @@
+#include "../../include/graphs/spring-network.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+graphs::SpringNetwork::SpringNetwork(Scene &scene, const BallSpec &ball, float springCoefficient)
+    : scene(scene),
+      ball(ball),
+      springCoefficient(springCoefficient)
+{
+    // the springs the scene already has are never added again
+    this->edges.reserve(this->scene.springs.size());
+    for (const SpringSpec &spring : this->scene.springs)
+    {
+        this->edges.insert(edgeKey(spring.ball1, spring.ball2));
+    }
+}
+
+// the smaller index goes into the high half, so both directions give the same key
+std::uint64_t graphs::SpringNetwork::edgeKey(int ball1, int ball2)
+{
+    std::uint64_t first = static_cast<std::uint32_t>(std::min(ball1, ball2));
+    std::uint64_t second = static_cast<std::uint32_t>(std::max(ball1, ball2));
+    return (first << 32) | second;
+}
+
+void graphs::SpringNetwork::reserve(int ballCount, int springCount)
+{
+    this->scene.balls.reserve(this->scene.balls.size() + ballCount);
+    this->scene.springs.reserve(this->scene.springs.size() + springCount);
+    this->edges.reserve(this->scene.springs.size() + springCount);
+}
+
+int graphs::SpringNetwork::addBall(const linalg::Vector &pos)
+{
+    this->scene.balls.push_back({pos, this->ball.color, this->ball.radius, this->ball.mass, this->ball.elasticity});
+    return this->scene.balls.size() - 1;
+}
+
+bool graphs::SpringNetwork::addSpring(int ball1, int ball2)
+{
+    int ballCount = this->scene.balls.size();
+    if (ball1 < 0 || ball1 >= ballCount || ball2 < 0 || ball2 >= ballCount)
+    {
+        return false;
+    }
+    if (ball1 == ball2 || !this->edges.insert(edgeKey(ball1, ball2)).second)
+    {
+        return false;
+    }
+
+    // the spring rests at the distance the balls are created at
+    float normalLength = (this->scene.balls[ball2].pos - this->scene.balls[ball1].pos).magnitude();
+    this->scene.springs.push_back({ball1, ball2, normalLength, this->springCoefficient});
+    return true;
+}
+
+int graphs::SpringNetwork::addEdges(const std::vector<std::array<int, 2>> &edges)
+{
+    this->reserve(0, edges.size());
+
+    int added = 0;
+    for (const std::array<int, 2> &edge : edges)
+    {
+        added += this->addSpring(edge[0], edge[1]);
+    }
+    return added;
+}
+
+void graphs::SpringNetwork::addCloth(linalg::Vector origin, int columns, int rows, float spacing, bool hasShearSprings)
+{
+    // structural springs to the right and below, shear springs on both diagonals
+    int springsPerBall = hasShearSprings ? 4 : 2;
+    this->reserve(columns * rows, columns * rows * springsPerBall);
+
+    int first = this->scene.balls.size();
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < columns; column++)
+        {
+            this->addBall(origin + linalg::Vector(column * spacing, row * spacing));
+        }
+    }
+
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < columns; column++)
+        {
+            int ball = first + row * columns + column;
+            if (column + 1 < columns)
+            {
+                this->addSpring(ball, ball + 1);
+            }
+            if (row + 1 < rows)
+            {
+                this->addSpring(ball, ball + columns);
+            }
+            if (hasShearSprings && column + 1 < columns && row + 1 < rows)
+            {
+                this->addSpring(ball, ball + columns + 1);
+                this->addSpring(ball + 1, ball + columns);
+            }
+        }
+    }
+}
+
+void graphs::SpringNetwork::addLattice(linalg::Vector origin, int columns, int rows, float spacing)
+{
+    // odd rows are shifted by half a spacing, every ball is joined to its six neighbours
+    float rowHeight = spacing * 0.8660254f;
+    this->reserve(columns * rows, columns * rows * 3);
+
+    int first = this->scene.balls.size();
+    for (int row = 0; row < rows; row++)
+    {
+        float shift = (row % 2 == 1) ? spacing / 2.f : 0.f;
+        for (int column = 0; column < columns; column++)
+        {
+            this->addBall(origin + linalg::Vector(column * spacing + shift, row * rowHeight));
+        }
+    }
+
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < columns; column++)
+        {
+            int ball = first + row * columns + column;
+            if (column + 1 < columns)
+            {
+                this->addSpring(ball, ball + 1);
+            }
+            if (row + 1 == rows)
+            {
+                continue;
+            }
+
+            // the two neighbours of the next row
+            int left = (row % 2 == 1) ? column : column - 1;
+            for (int below = left; below <= left + 1; below++)
+            {
+                if (below >= 0 && below < columns)
+                {
+                    this->addSpring(ball, first + (row + 1) * columns + below);
+                }
+            }
+        }
+    }
+}
+
+bool graphs::SpringNetwork::addMesh(const std::vector<linalg::Vector> &vertices, const std::vector<std::array<int, 3>> &triangles)
+{
+    // the whole mesh is checked first, so a bad triangle does not leave half of it in the scene
+    for (const std::array<int, 3> &triangle : triangles)
+    {
+        for (int index : triangle)
+        {
+            if (index < 0 || index >= vertices.size())
+            {
+                return false;
+            }
+        }
+    }
+
+    // an inner edge is shared by two triangles, the hashed edges keep one spring of it
+    this->reserve(vertices.size(), triangles.size() * 3);
+
+    int first = this->scene.balls.size();
+    for (const linalg::Vector &vertex : vertices)
+    {
+        this->addBall(vertex);
+    }
+    for (const std::array<int, 3> &triangle : triangles)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            this->addSpring(first + triangle[i], first + triangle[(i + 1) % 3]);
+        }
+    }
+    return true;
+}
+
+// reads the vertex index of a face corner like "3", "3/1" or "-2//4", returns false if it is not a number
+static bool parseCorner(const std::string &corner, long &index)
+{
+    const char *start = corner.c_str();
+    char *end = nullptr;
+    errno = 0;
+    index = std::strtol(start, &end, 10);
+    return end != start && (*end == '\0' || *end == '/') && errno != ERANGE && index != 0 && index > INT_MIN && index < INT_MAX;
+}
+
+bool graphs::SpringNetwork::importMesh(const std::string &path, linalg::Vector offset, float scale)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<linalg::Vector> vertices;
+    std::vector<std::array<int, 3>> triangles;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "v")
+        {
+            float x = 0.f, y = 0.f;
+            if (!(stream >> x >> y))
+            {
+                return false;
+            }
+            vertices.push_back(offset + linalg::Vector(x, y) * scale);
+        }
+        else if (type == "f")
+        {
+            // indices start at 1, negative ones count back from the last vertex, texture and normal indices are skipped
+            std::vector<int> face;
+            std::string corner;
+            while (stream >> corner)
+            {
+                long index = 0;
+                if (!parseCorner(corner, index))
+                {
+                    return false;
+                }
+                face.push_back(static_cast<int>((index < 0) ? static_cast<long>(vertices.size()) + index : index - 1));
+            }
+
+            // polygons are split into a fan of triangles
+            for (int i = 1; i + 1 < face.size(); i++)
+            {
+                triangles.push_back({face[0], face[i], face[i + 1]});
+            }
+        }
+    }
+
+    return this->addMesh(vertices, triangles);
+}
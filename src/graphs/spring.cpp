@@ -1,6 +1,8 @@
 #include "../../include/graphs/spring.hpp"
 #include "../../include/physics/physics.hpp"
 
+thread_local std::vector<graphs::Spring> graphs::Springs;
+
 graphs::Spring::Spring(graphs::SoftBody &body, graphs::Ball &ball1, graphs::Ball &ball2, float normalLength, float springCoefficient, sf::Color color)
     : body(body), 
     ball1(ball1),
@@ -9,24 +11,9 @@ graphs::Spring::Spring(graphs::SoftBody &body, graphs::Ball &ball1, graphs::Ball
       normalLength(normalLength),
       springCoefficient(springCoefficient),
       currentLength(0.f),
+      potentialEnergy(0.f),
       springForce(0.f, 0.f)
 {
-    bool exists = false;
-
-    // prevents to create same spring twice or more
-    for (graphs::Spring &spring : body.edgeSprings)
-    {
-        if ((&this->ball1 == &spring.ball1 && &this->ball2 == &spring.ball2) ||
-            (&this->ball1 == &spring.ball2 && &this->ball2 == &spring.ball1))
-        {
-            exists = true;
-            break;
-        }
-    }
-    if (exists)
-    {
-        return;
-    }
 }
 
 graphs::Spring::Spring(graphs::Ball &ball1, graphs::Ball &ball2, float normalLength, float springCoefficient, sf::Color color)
@@ -37,34 +24,19 @@ graphs::Spring::Spring(graphs::Ball &ball1, graphs::Ball &ball2, float normalLen
       normalLength(normalLength),
       springCoefficient(springCoefficient),
       currentLength(0.f),
+      potentialEnergy(0.f),
       springForce(0.f, 0.f)
 {
-    bool exists = false;
-
-    // prevents to create same spring twice or more
-    for (graphs::Spring &spring : graphs::Springs)
-    {
-        if ((&this->ball1 == &spring.ball1 && &this->ball2 == &spring.ball2) ||
-            (&this->ball1 == &spring.ball2 && &this->ball2 == &spring.ball1))
-        {
-            exists = true;
-            break;
-        }
-    }
-    if (exists)
-    {
-        return;
-    }
 }
 
-void graphs::Spring::draw(sf::RenderWindow &window)
+void graphs::Spring::draw(sf::RenderTarget &target)
 {
     std::array<sf::Vertex, 2> line =
         {
             sf::Vertex{sf::Vector2f(this->ball1.pos.x, this->ball1.pos.y), this->color},
             sf::Vertex{sf::Vector2f(this->ball2.pos.x, this->ball2.pos.y), this->color}};
     
-    window.draw(line.data(), line.size(), sf::PrimitiveType::Lines);
+    target.draw(line.data(), line.size(), sf::PrimitiveType::Lines);
 }
 
 void graphs::Spring::computeSpringForce()
@@ -78,6 +50,10 @@ void graphs::Spring::computeSpringForce()
     float springForceMagnitude = -this->springCoefficient * (this->normalLength - this->currentLength) * physics::PIXEL_PER_METER;
     this->springForce = normalVector * springForceMagnitude;
 
+    // stored energy in joules, the spring pulls with springCoefficient newtons per pixel of stretch
+    float stretch = this->currentLength - this->normalLength;
+    this->potentialEnergy = 0.5f * this->springCoefficient * stretch * stretch / physics::PIXEL_PER_METER;
+
     if (!this->ball1.isBeingDragged)
     {
         this->ball1.springForce = this->ball1.springForce + this->springForce;
@@ -0,0 +1,193 @@
+#include "../../include/graphs/static-world.hpp"
+#include <algorithm>
+
+graphs::StaticWorld graphs::World(1200.f, 900.f);
+
+// maximum number of segments in a leaf and depth of the traversal stack
+static const int LEAF_SIZE = 4;
+static const int STACK_SIZE = 64;
+
+graphs::StaticWorld::StaticWorld(float width, float height, sf::Color color)
+    : bounds(linalg::Vector(0.f, 0.f), linalg::Vector(width, height)),
+      lines(sf::PrimitiveType::Lines),
+      color(color),
+      isBuilt(false)
+{
+}
+
+bool graphs::StaticWorld::addSegment(const linalg::Vector &start, const linalg::Vector &end)
+{
+    // the tree is shared by the threads once it is built, changing it would race with their queries
+    if (this->isBuilt)
+    {
+        return false;
+    }
+
+    this->segments.push_back({start, end});
+    return true;
+}
+
+bool graphs::StaticWorld::addPolyline(const std::vector<linalg::Vector> &points)
+{
+    if (this->isBuilt)
+    {
+        return false;
+    }
+
+    for (int i = 0; i + 1 < points.size(); i++)
+    {
+        this->addSegment(points[i], points[i + 1]);
+    }
+    return true;
+}
+
+bool graphs::StaticWorld::addConvexPolygon(const std::vector<linalg::Vector> &points)
+{
+    if (!this->addPolyline(points))
+    {
+        return false;
+    }
+
+    if (points.size() > 2)
+    {
+        this->addSegment(points.back(), points.front()); // closes the polygon
+    }
+    return true;
+}
+
+void graphs::StaticWorld::build()
+{
+    this->isBuilt = true;
+    this->nodes.clear();
+    this->nodes.reserve(2 * this->segments.size() / LEAF_SIZE + 1);
+    if (!this->segments.empty())
+    {
+        this->buildNode(0, this->segments.size());
+    }
+
+    // vertices are created once, drawing does not rebuild them
+    this->lines.clear();
+    for (const Segment &segment : this->segments)
+    {
+        this->lines.append(sf::Vertex{sf::Vector2f(segment.start.x, segment.start.y), this->color});
+        this->lines.append(sf::Vertex{sf::Vector2f(segment.end.x, segment.end.y), this->color});
+    }
+}
+
+int graphs::StaticWorld::buildNode(int first, int count)
+{
+    int index = this->nodes.size();
+    this->nodes.push_back(Node());
+
+    linalg::AABB box = linalg::AABB::fromSegment(this->segments[first].start, this->segments[first].end);
+    linalg::AABB centers(box.center(), box.center());
+    for (int i = first + 1; i < first + count; i++)
+    {
+        linalg::AABB segmentBox = linalg::AABB::fromSegment(this->segments[i].start, this->segments[i].end);
+        box = box.merge(segmentBox);
+        centers = centers.merge(linalg::AABB(segmentBox.center(), segmentBox.center()));
+    }
+
+    if (count <= LEAF_SIZE)
+    {
+        this->nodes[index] = {box, -1, first, count};
+        return index;
+    }
+
+    // splits at the median of the segment centers along the longest axis
+    linalg::Vector extent = centers.size();
+    bool splitX = extent.x > extent.y;
+    int half = count / 2;
+    std::nth_element(this->segments.begin() + first, this->segments.begin() + first + half, this->segments.begin() + first + count,
+                     [splitX](const Segment &a, const Segment &b)
+                     {
+                         return splitX ? (a.start.x + a.end.x < b.start.x + b.end.x) : (a.start.y + a.end.y < b.start.y + b.end.y);
+                     });
+
+    this->buildNode(first, half);
+    int right = this->buildNode(first + half, count - half);
+    this->nodes[index] = {box, right, 0, 0};
+
+    return index;
+}
+
+template <typename Visit>
+void graphs::StaticWorld::forEachSegment(const linalg::AABB &box, Visit visit) const
+{
+    // a world that is not built has no tree and no segment is hit
+    if (this->nodes.empty())
+    {
+        return;
+    }
+
+    int stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node &node = this->nodes[stack[--stackSize]];
+        if (!node.box.overlaps(box))
+        {
+            continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; i++)
+            {
+                visit(i);
+            }
+        }
+        else
+        {
+            int left = &node - this->nodes.data() + 1;
+            stack[stackSize++] = node.right;
+            stack[stackSize++] = left;
+        }
+    }
+}
+
+void graphs::StaticWorld::query(const linalg::AABB &box, std::vector<int> &result) const
+{
+    result.clear();
+    this->forEachSegment(box, [this, &box, &result](int i)
+                         {
+                             if (linalg::AABB::fromSegment(this->segments[i].start, this->segments[i].end).overlaps(box))
+                             {
+                                 result.push_back(i);
+                             }
+                         });
+}
+
+void graphs::StaticWorld::checkBallCollision(graphs::Ball &ball) const
+{
+    this->forEachSegment(linalg::AABB::fromCircle(ball.pos, ball.radius), [this, &ball](int i)
+                         { ball.checkSegmentCollision(this->segments[i].start, this->segments[i].end); });
+}
+
+float graphs::StaticWorld::sweptBallCollision(const graphs::Ball &ball, float deltaTime, int &hitSegment) const
+{
+    float earliestTime = 2.f;
+    hitSegment = -1;
+
+    // box around the whole motion of the step
+    linalg::AABB sweptBox = linalg::AABB::fromCircle(ball.pos, ball.radius).merge(linalg::AABB::fromCircle(ball.pos + ball.vel * deltaTime, ball.radius));
+
+    this->forEachSegment(sweptBox, [this, &ball, deltaTime, &earliestTime, &hitSegment](int i)
+                         {
+                             float time = ball.sweptSegmentCollision(this->segments[i].start, this->segments[i].end, linalg::Vector(0.f, 0.f), deltaTime);
+                             if (time < earliestTime)
+                             {
+                                 earliestTime = time;
+                                 hitSegment = i;
+                             }
+                         });
+
+    return earliestTime;
+}
+
+void graphs::StaticWorld::draw(sf::RenderTarget &target) const
+{
+    target.draw(this->lines);
+}
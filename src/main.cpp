@@ -1,265 +1,291 @@
 #include "../include/physics/physics.hpp"
+#include "../include/physics/simulation.hpp"
+#include "../include/physics/domain.hpp"
+#include "../include/physics/ensemble.hpp"
+#include "../include/physics/spatial-grid.hpp"
+#include "../include/physics/metrics.hpp"
+#include "../include/physics/morton.hpp"
+#include "../include/physics/frame-arena.hpp"
 #include "../include/graphs/spring.hpp"
 #include "../include/graphs/soft-body.hpp"
+#include "../include/graphs/static-world.hpp"
+#include "../include/graphs/scene.hpp"
+#include "../include/render/render.hpp"
+#include "../include/render/frame-recorder.hpp"
+#include "../include/render/camera.hpp"
+#include <iostream>
 #include <optional>
 #include <random>
+#include <string>
 
-std::vector<graphs::Ball> graphs::Balls;
-std::vector<graphs::Spring> graphs::Springs;
-std::vector<graphs::SoftBody> graphs::SoftBodys;
-
-// creates random number
-float getRandomNumber(float min, float max)
-{
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<> distrib(min, max);
-
-    return distrib(gen);
-}
-
-int main()
+int main(int argc, char *argv[])
 {
     int selectedBall = -1;
     int selectedBody = -1;
     int numberOfBalls = 5;
     int numberOfSoftBodys = 2;
+    int numberOfDomains = 1;
+    int numberOfRuns = 0;
+    int numberOfFrames = 600;
+    int numberOfThreads = 0;
+    int numberOfRopeLinks = 0;
+    unsigned seed = std::random_device()();
+    std::string ensemblePath;
+    std::string recordDirectory;
+    sf::Vector2u recordSize(1200, 900);
+    float recordFrameRate = 60.f;
+    render::ImageFormat recordFormat = render::ImageFormat::Png;
+    sf::Vector2f worldSize(1200.f, 900.f);
+    void (*stepWorld)() = physics::step;
+
+    // command line options
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--domains" && i + 1 < argc)
+        {
+            numberOfDomains = std::stoi(argv[++i]); // number of worker processes
+        }
+        else if (option == "--ensemble" && i + 2 < argc)
+        {
+            numberOfRuns = std::stoi(argv[++i]); // number of independent runs
+            ensemblePath = argv[++i];            // output file of the runs
+        }
+        else if (option == "--frames" && i + 1 < argc)
+        {
+            numberOfFrames = std::stoi(argv[++i]);
+        }
+        else if (option == "--threads" && i + 1 < argc)
+        {
+            numberOfThreads = std::stoi(argv[++i]);
+        }
+        else if (option == "--seed" && i + 1 < argc)
+        {
+            seed = std::stoul(argv[++i]);
+        }
+        else if (option == "--record" && i + 1 < argc)
+        {
+            recordDirectory = argv[++i]; // renders offscreen into an image sequence
+        }
+        else if (option == "--size" && i + 1 < argc)
+        {
+            std::string size = argv[++i]; // width x height, e.g. 1920x1440
+            recordSize = sf::Vector2u(std::stoi(size), std::stoi(size.substr(size.find('x') + 1)));
+        }
+        else if (option == "--fps" && i + 1 < argc)
+        {
+            recordFrameRate = std::stof(argv[++i]);
+        }
+        else if (option == "--raw")
+        {
+            recordFormat = render::ImageFormat::Raw;
+        }
+        else if (option == "--rope" && i + 1 < argc)
+        {
+            numberOfRopeLinks = std::stoi(argv[++i]); // adds a pinned rope with this many links
+        }
+        else if (option == "--multi-rate")
+        {
+            stepWorld = physics::multiRateStep; // every island takes the sub-steps its stiffness and speed need
+        }
+        else if (option == "--world" && i + 1 < argc)
+        {
+            std::string size = argv[++i]; // width x height of the world bounds, the window shows it through the camera
+            worldSize = sf::Vector2f(std::stof(size), std::stof(size.substr(size.find('x') + 1)));
+        }
+        else if (option == "--metrics" && i + 1 < argc)
+        {
+            physics::metrics.path = argv[++i]; // file the metrics are exported to
+        }
+        else if (option == "--metrics-format" && i + 1 < argc)
+        {
+            std::string format = argv[++i];
+            physics::metrics.format = (format == "line") ? physics::MetricsFormat::LineProtocol : physics::MetricsFormat::Prometheus;
+        }
+        else if (option == "--metrics-interval" && i + 1 < argc)
+        {
+            physics::metrics.sampleInterval = std::stoi(argv[++i]); // frames between two samples
+        }
+    }
 
-    // set anti aliasing level
-    sf::ContextSettings settings;
-    settings.antiAliasingLevel = 16;
+    graphs::World.bounds = linalg::AABB(linalg::Vector(0.f, 0.f), linalg::Vector(worldSize.x, worldSize.y));
 
-    // create the window
-    sf::RenderWindow window(sf::VideoMode({1200, 900}), "My window", sf::Style::Close, sf::State::Windowed, settings);
-    window.setVerticalSyncEnabled(true);
+    // creates static obstacles, they are loaded once into the tree
+    graphs::World.addPolyline({linalg::Vector(80.f, 620.f), linalg::Vector(300.f, 700.f), linalg::Vector(420.f, 700.f)});
+    graphs::World.addSegment(linalg::Vector(780.f, 720.f), linalg::Vector(1120.f, 600.f));
+    graphs::World.build();
 
-    // creates random balls
-    for (int i = 0; i < numberOfBalls; i++)
+    // creates the random scene
+    graphs::Scene scene = graphs::Scene::random(seed, numberOfBalls, numberOfSoftBodys);
+    if (numberOfRopeLinks > 1)
     {
-        float red = getRandomNumber(0.f, 255.f);   // red
-        float green = getRandomNumber(0.f, 255.f); // green
-        float blue = getRandomNumber(0.f, 255.f);  // blue
-        float x = getRandomNumber(0.f, 1200.f);    // x position
-        float y = getRandomNumber(0.f, 900.f);     // y position
-        float r = getRandomNumber(30.f, 50.f);     // radius
-        float m = getRandomNumber(10.f, 20.f);     // mass
-        float e = getRandomNumber(0.1f, 0.6f);     // elasticity
-
-        graphs::Balls.emplace_back(linalg::Vector(x, y), sf::Color(red, green, blue), r, m, e); // position, color, radius, mass, elasticity
+        scene.ropes.push_back({linalg::Vector(300.f, 80.f), linalg::Vector(900.f, 80.f), numberOfRopeLinks, sf::Color::White, 3.f, 5.f, 0.3f, true}); // start, end, links, color, link radius, mass, elasticity, pinned
     }
 
-    // creates random bodys
-    for (int i = 0; i < numberOfSoftBodys; i++)
+    // parameter study without a window
+    if (numberOfRuns > 0)
     {
-        float red = getRandomNumber(0.f, 255.f);   // red
-        float green = getRandomNumber(0.f, 255.f); // green
-        float blue = getRandomNumber(0.f, 255.f);  // blue
-        float x = getRandomNumber(0.f, 1200.f);    // x position
-        float y = getRandomNumber(0.f, 900.f);     // y position
-        float r = getRandomNumber(50.f, 70.f);     // radius
-        float m = getRandomNumber(10.f, 20.f);     // mass
-        float e = getRandomNumber(0.1f, 0.5f);     // elasticity
-        float s = getRandomNumber(0.1f, 0.8f);     // spring stiffness
-        float p = getRandomNumber(0.f, 0.05f);     // pressure stiffness
-
-        graphs::SoftBodys.emplace_back(linalg::Vector(x, y), sf::Color(red, green, blue), 25, r, m, e, s, p); // position, color, radius, mass, elasticity
+        physics::Ensemble ensemble(scene, numberOfRuns, numberOfFrames, numberOfThreads, seed);
+        if (!ensemble.run(ensemblePath))
+        {
+            std::cerr << "can not write " << ensemblePath << std::endl;
+            return 1;
+        }
+        return 0;
     }
 
-    graphs::Springs.emplace_back(graphs::Balls.at(0), graphs::Balls.at(1), 200.f, 0.5f);
+    scene.load();
 
-    // run the program as long as the window is open
-    while (window.isOpen())
+    // offscreen rendering without a window
+    if (!recordDirectory.empty())
     {
-        // check all the window's events that were triggered since the last iteration of the loop
-        while (const std::optional event = window.pollEvent())
+        render::FrameRecorder recorder(recordDirectory, recordSize, recordFormat);
+        if (!recorder.start())
         {
-            // "close requested" event: we close the window
-            if (event->is<sf::Event::Closed>())
-            {
-                window.close();
-            }
+            std::cerr << "can not create the render textures" << std::endl;
+            return 1;
         }
 
-        bool mousePressed = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-        linalg::Vector mouseVector(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
+        const linalg::AABB &bounds = graphs::World.bounds;
+        sf::View view(sf::FloatRect({bounds.min.x, bounds.min.y}, {bounds.size().x, bounds.size().y}));
 
-        // Sub-Steps
-        for (int step = 0; step < physics::SUB_STEPS; step++)
+        // the simulation keeps its fixed step, the output frames sample it at the chosen rate
+        float simulatedTime = 0.f;
+        for (int frame = 0; frame < numberOfFrames; frame++)
         {
-            // resets forces
-            for (graphs::SoftBody &body : graphs::SoftBodys)
-            {
-                for (graphs::Ball &ball : body.cornerBalls)
-                {
-                    ball.springForce = linalg::Vector(0.f, 0.f);
-                    ball.pressureForce = linalg::Vector(0.f, 0.f);
-                }
-            }
-            for (graphs::Ball &ball : graphs::Balls)
-            {
-                ball.springForce = linalg::Vector(0.f, 0.f);
-                ball.pressureForce = linalg::Vector(0.f, 0.f);
-            }
+            recorder.record(view);
 
-            // computes forces
-            for (graphs::SoftBody &body : graphs::SoftBodys)
+            float frameEnd = (frame + 1) / recordFrameRate;
+            while (simulatedTime + physics::FIXED_DELTA_TIME / 2 < frameEnd)
             {
-                for (graphs::Spring &spring : body.edgeSprings)
-                {
-                    spring.computeSpringForce();
-                }
-                body.computePressureForce();
-            }
-            for (graphs::Spring &spring : graphs::Springs)
-            {
-                spring.computeSpringForce();
+                physics::metrics.beginStep();
+                stepWorld();
+                physics::metrics.endStep();
+                simulatedTime += physics::FIXED_DELTA_TIME;
             }
+        }
 
-            // physics
-            // update soft body
-            for (graphs::SoftBody &body : graphs::SoftBodys)
-            {
-                for (graphs::Ball &ball : body.cornerBalls)
-                {
-                    ball.computeDragForce();
-                    ball.computeFrictionForce();
-                    ball.checkWallCollision();
-                    ball.update(physics::SUB_DELTA_TIME);
-                }
+        recorder.finish();
+        if (recorder.frameCount > 0)
+        {
+            std::cout << "read back " << recorder.frameCount << " frames, " << recorder.readBackMilliseconds / recorder.frameCount << " ms per frame" << std::endl;
+        }
+        return recorder.hasFailed ? 1 : 0;
+    }
 
-                body.update(); // update center of body
-            }
+    // workers are forked before the window exists, they get a copy of the scene
+    physics::DomainCoordinator coordinator(numberOfDomains, 150.f);
+    coordinator.stepWorld = stepWorld;
+    // ropes are not split into domains, they keep the world in one process
+    bool isDistributed = numberOfDomains > 1 && scene.ropes.empty() && coordinator.start();
 
-            // update balls
-            for (graphs::Ball &ball : graphs::Balls)
-            {
-                ball.computeDragForce();
-                ball.computeFrictionForce();
-                ball.checkWallCollision();
-                ball.update(physics::SUB_DELTA_TIME);
-            }
+    // set anti aliasing level
+    sf::ContextSettings settings;
+    settings.antiAliasingLevel = 16;
 
-            // controls of collisions
+    // create the window
+    sf::RenderWindow window(sf::VideoMode({1200, 900}), "My window", sf::Style::Close, sf::State::Windowed, settings);
+    window.setVerticalSyncEnabled(true);
+
+    // acceleration structure for picking and culling
+    physics::SpatialGrid grid;
+    std::vector<physics::SpatialItem> pickedItems;
+    physics::MortonOrder mortonOrder;
+
+    // camera, starts showing the whole world
+    render::Camera camera(sf::Vector2f(1200.f, 900.f), graphs::World.bounds.center());
+    render::CulledRenderer renderer;
+    camera.reset(graphs::World.bounds);
+    sf::Vector2i lastMousePos = sf::Mouse::getPosition(window);
+
+    // run the program as long as the window is open
+    while (window.isOpen())
+    {
+        // transient data of the previous frame is released
+        physics::frameArena.reset();
 
-            // ball vs ball
-            for (int i = 0; i < graphs::Balls.size(); i++)
+        // check all the window's events that were triggered since the last iteration of the loop
+        while (const std::optional event = window.pollEvent())
+        {
+            // "close requested" event: we close the window
+            if (event->is<sf::Event::Closed>())
             {
-                for (int j = i + 1; j < graphs::Balls.size(); j++)
-                {
-                    graphs::Balls.at(i).checkBallCollision(graphs::Balls.at(j));
-                }
+                window.close();
             }
-
-            // ball vs body
-            for (graphs::Ball &looseBall : graphs::Balls)
+            // wheel zooms around the cursor
+            else if (const auto *scrolled = event->getIf<sf::Event::MouseWheelScrolled>())
             {
-                for (graphs::SoftBody &body : graphs::SoftBodys)
-                {
-                    // ball vs ball of softbody
-                    for (graphs::Ball &cornerBall : body.cornerBalls)
-                    {
-                        looseBall.checkBallCollision(cornerBall);
-                    }
-                    // ball vs spring of softbody
-                    for (graphs::Spring &spring : body.edgeSprings)
-                    {
-                        looseBall.checkSpringCollision(spring);
-                    }
-                }
+                sf::Vector2f point = window.mapPixelToCoords(scrolled->position, camera.view);
+                camera.zoomAt(scrolled->delta > 0 ? 0.9f : 1.f / 0.9f, linalg::Vector(point.x, point.y));
             }
-
-            // balls vs springs
-            for (graphs::Ball &ball : graphs::Balls)
+            else if (const auto *keyPressed = event->getIf<sf::Event::KeyPressed>())
             {
-                for (graphs::Spring &spring : graphs::Springs)
+                // F follows the selected soft body, R shows the whole world again
+                if (keyPressed->code == sf::Keyboard::Key::F)
                 {
-                    ball.checkSpringCollision(spring);
+                    camera.follow(selectedBody);
                 }
-            }
-
-            // balls of body vs springs
-            for (graphs::SoftBody &body : graphs::SoftBodys)
-            {
-                for (graphs::Ball &cornerBall : body.cornerBalls)
+                else if (keyPressed->code == sf::Keyboard::Key::R)
                 {
-                    for (graphs::Spring &freeSpring : graphs::Springs)
-                    {
-                        cornerBall.checkSpringCollision(freeSpring);
-                    }
+                    camera.reset(graphs::World.bounds);
                 }
             }
+        }
 
-            // body vs body
-            for (int i = 0; i < graphs::SoftBodys.size(); i++)
-            {
-                graphs::SoftBody &bodyA = graphs::SoftBodys[i];
-
-                for (int j = i + 1; j < graphs::SoftBodys.size(); j++)
-                {
-                    graphs::SoftBody &bodyB = graphs::SoftBodys[j];
-
-                    // balls of body1 vs balls of body2
-                    for (graphs::Ball &ballA : bodyA.cornerBalls)
-                    {
-                        for (graphs::Ball &ballB : bodyB.cornerBalls)
-                        {
-                            ballA.checkBallCollision(ballB);
-                        }
-                    }
-
-                    // balls of body1 vs springs of body2
-                    for (graphs::Ball &ballA : bodyA.cornerBalls)
-                    {
-                        for (graphs::Spring &springB : bodyB.edgeSprings)
-                        {
-                            ballA.checkSpringCollision(springB);
-                        }
-                    }
+        // arrow keys and the right button pan the camera, this stops following
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        linalg::Vector keyPan(0.f, 0.f);
+        keyPan.x = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) - sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left);
+        keyPan.y = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down) - sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up);
+        if (keyPan.x != 0.f || keyPan.y != 0.f)
+        {
+            camera.follow(-1);
+            camera.pan(keyPan * (600.f * camera.zoom * physics::FIXED_DELTA_TIME)); // 600 pixels per second
+        }
+        if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Right))
+        {
+            sf::Vector2f from = window.mapPixelToCoords(lastMousePos, camera.view);
+            sf::Vector2f to = window.mapPixelToCoords(mousePos, camera.view);
+            camera.follow(-1);
+            camera.pan(linalg::Vector(from.x - to.x, from.y - to.y));
+        }
+        lastMousePos = mousePos;
 
-                    // balls of body2 vs springs of body1
-                    for (graphs::Ball &ballB : bodyB.cornerBalls)
-                    {
-                        for (graphs::Spring &springA : bodyA.edgeSprings)
-                        {
-                            ballB.checkSpringCollision(springA);
-                        }
-                    }
-                }
-            }
+        // the cursor in world coordinates
+        bool mousePressed = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+        sf::Vector2f mouseWorld = window.mapPixelToCoords(mousePos, camera.view);
+        linalg::Vector mouseVector(mouseWorld.x, mouseWorld.y);
 
-            // SoftBody'nin Kendi İç Çarpışmaları (Top vs Top)
-            for (graphs::SoftBody &body : graphs::SoftBodys)
-            {
-                for (int i = 0; i < body.cornerBalls.size(); i++)
-                {
-                    graphs::Ball &ball1 = body.cornerBalls[i];
-                    for (int j = i + 1; j < body.cornerBalls.size(); j++)
-                    {
-                        graphs::Ball &ball2 = body.cornerBalls[j];
-                        ball1.checkBallCollision(ball2);
-                    }
-                }
-            }
+        // sub-steps, in the worker processes when the world is split into domains
+        physics::metrics.beginStep();
+        if (!isDistributed || !coordinator.step())
+        {
+            isDistributed = false;
+            stepWorld();
+        }
+        physics::metrics.endStep();
 
-        } // end of substeps
+        // keeps the storage in spatial order, it is skipped while a selection, the camera or the domain workers hold an index
+        if (!isDistributed && selectedBall == -1 && selectedBody == -1 && camera.followedBody == -1)
+        {
+            mortonOrder.update();
+        }
 
-        // mouse control
+        // mouse control, the objects under the cursor come from the grid
+        grid.build();
+        pickedItems.clear();
+        if (mousePressed)
+        {
+            grid.queryPoint(mouseVector, 0.f, pickedItems);
+        }
 
         // for array of soft bodys
-        for (int i = 0; i < graphs::SoftBodys.size(); i++)
+        for (const physics::SpatialItem &item : pickedItems)
         {
-            if (mousePressed)
+            // Sadece başka bir top seçili değilse body'yi seç
+            if (item.kind == physics::ItemKind::SoftBody && selectedBall == -1)
             {
-                // Sadece başka bir top seçili değilse body'yi seç
-                if (selectedBall == -1)
-                {
-                    float distance = (graphs::SoftBodys.at(i).center - mouseVector).magnitude();
-                    if (distance < graphs::SoftBodys.at(i).radius)
-                    {
-                        selectedBody = i;
-                    }
-                }
+                selectedBody = item.body;
             }
         }
         if (mousePressed && selectedBody != -1)
@@ -277,19 +303,12 @@ int main()
         }
 
         // for array of balls
-        for (int i = 0; i < graphs::Balls.size(); i++)
+        for (const physics::SpatialItem &item : pickedItems)
         {
-            if (mousePressed)
+            // Sadece bir body seçili değilse topu seç
+            if (item.kind == physics::ItemKind::Ball && selectedBody == -1)
             {
-                // Sadece bir body seçili değilse topu seç
-                if (selectedBody == -1)
-                {
-                    float distance = (graphs::Balls.at(i).pos - mouseVector).magnitude();
-                    if (distance < graphs::Balls.at(i).radius)
-                    {
-                        selectedBall = i;
-                    }
-                }
+                selectedBall = item.index;
             }
         }
         if (mousePressed && selectedBall != -1)
@@ -302,28 +321,12 @@ int main()
             selectedBall = -1;
         }
 
-        // drawings
+        // drawings, only the objects inside the camera are submitted
+        camera.update();
+        window.setView(camera.view);
         window.clear(sf::Color::Black);
-        for (graphs::Ball &ball : graphs::Balls)
-        {
-            ball.draw(window);
-        }
-        for (graphs::Spring &spring : graphs::Springs)
-        {
-            spring.draw(window);
-        }
-        for (graphs::SoftBody &body : graphs::SoftBodys)
-        {
-            // body.draw(window);
-            for (graphs::Ball &ball : body.cornerBalls)
-            {
-                ball.draw(window);
-            }
-            for (graphs::Spring &spring : body.edgeSprings)
-            {
-                spring.draw(window);
-            }
-        }
+        graphs::World.draw(window);
+        renderer.draw(window, grid, camera);
         window.display(); // end the current frame
     }
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "../../include/physics/allocation-counter.hpp"
+
+#ifdef PHYSICS_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long long> allocations(0);
+
+// the array and nothrow forms call these, so replacing them counts every form
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    if (void *memory = _aligned_malloc(size == 0 ? 1 : size, align))
+#else
+    if (void *memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+#endif
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+bool physics::isCountingAllocations()
+{
+    return true;
+}
+
+long long physics::allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+#else
+bool physics::isCountingAllocations()
+{
+    return false;
+}
+
+long long physics::allocationCount()
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,581 @@
+#include "../../include/physics/domain.hpp"
+#include "../../include/physics/simulation.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// counts at the start of every message
+struct FrameHeader
+{
+    int ballCount, springCount, bodyCount;
+};
+
+// appends the bytes of a value to the message
+template <typename T>
+static void writeValue(std::vector<char> &message, const T &value)
+{
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    message.insert(message.end(), bytes, bytes + sizeof(T));
+}
+
+// reads a value from the message and moves the offset after it
+template <typename T>
+static T readValue(const std::vector<char> &message, size_t &offset)
+{
+    T value;
+    std::memcpy(&value, message.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+static physics::BallState makeBallState(const graphs::Ball &ball, int id, bool isGhost)
+{
+    return {ball.pos.x, ball.pos.y, ball.vel.x, ball.vel.y, ball.radius, ball.mass, ball.elasticity, id, ball.isBeingDragged, ball.isTouchWall, isGhost};
+}
+
+// copies the simulated state back, the rest of the ball stays as it is
+static void applyBallState(graphs::Ball &ball, const physics::BallState &state)
+{
+    ball.pos = linalg::Vector(state.x, state.y);
+    ball.vel = linalg::Vector(state.vx, state.vy);
+    ball.isTouchWall = state.isTouchWall;
+}
+
+// ghosts are simulated like the owned particles so the contacts at the border are the same on both sides, their result is dropped
+static void syncBallState(graphs::Ball &ball, const physics::BallState &state)
+{
+    applyBallState(ball, state);
+    ball.isBeingDragged = state.isBeingDragged;
+}
+
+// returns true if the particles of the frame are the ones of the last frame, in the same order
+template <typename T>
+static bool isSameLayout(const std::vector<T> &states, const std::vector<T> &lastStates)
+{
+    if (states.size() != lastStates.size())
+    {
+        return false;
+    }
+    for (int i = 0; i < states.size(); i++)
+    {
+        if (states[i].id != lastStates[i].id || states[i].isGhost != lastStates[i].isGhost)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __linux__
+static bool writeAll(int socket, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = send(socket, data, size, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool readAll(int socket, char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t received = recv(socket, data, size, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+// messages are prefixed by their size
+static bool sendMessage(int socket, const std::vector<char> &message)
+{
+    size_t size = message.size();
+    return writeAll(socket, reinterpret_cast<const char *>(&size), sizeof(size)) && writeAll(socket, message.data(), size);
+}
+
+static bool receiveMessage(int socket, std::vector<char> &message)
+{
+    size_t size = 0;
+    if (!readAll(socket, reinterpret_cast<char *>(&size), sizeof(size)))
+    {
+        return false;
+    }
+    message.resize(size);
+    return readAll(socket, message.data(), size);
+}
+#endif
+
+physics::Domain::Domain(float minX, float maxX, float halo) : minX(minX), maxX(maxX), halo(halo) {}
+
+bool physics::Domain::owns(const linalg::Vector &point) const
+{
+    return point.x >= this->minX && point.x < this->maxX;
+}
+
+bool physics::Domain::touches(const linalg::AABB &box) const
+{
+    return box.max.x >= this->minX - this->halo && box.min.x < this->maxX + this->halo;
+}
+
+physics::DomainCoordinator::DomainCoordinator(int domainCount, float halo) : stepWorld(physics::step)
+{
+    // the outer strips reach to infinity so particles outside the bounds keep an owner
+    const linalg::AABB &bounds = graphs::World.bounds;
+    float width = (bounds.max.x - bounds.min.x) / domainCount;
+
+    for (int i = 0; i < domainCount; i++)
+    {
+        float minX = (i == 0) ? -1e30f : bounds.min.x + width * i;
+        float maxX = (i == domainCount - 1) ? 1e30f : bounds.min.x + width * (i + 1);
+        this->domains.emplace_back(minX, maxX, halo);
+    }
+}
+
+physics::DomainCoordinator::~DomainCoordinator()
+{
+    this->stop();
+}
+
+bool physics::DomainCoordinator::start()
+{
+#ifdef __linux__
+    for (int i = 0; i < this->domains.size(); i++)
+    {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+        {
+            this->stop();
+            return false;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(pair[0]);
+            close(pair[1]);
+            this->stop();
+            return false;
+        }
+
+        if (pid == 0)
+        {
+            // the worker only keeps its own socket, it owns a copy of the scene and the static world
+            for (int socket : this->sockets)
+            {
+                close(socket);
+            }
+            close(pair[0]);
+            physics::runDomainWorker(pair[1], this->stepWorld);
+            _exit(0);
+        }
+
+        close(pair[1]);
+        this->sockets.push_back(pair[0]);
+        this->workers.push_back(pid);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void physics::DomainCoordinator::stop()
+{
+#ifdef __linux__
+    // closing the sockets ends the workers
+    for (int socket : this->sockets)
+    {
+        close(socket);
+    }
+    for (int worker : this->workers)
+    {
+        waitpid(worker, nullptr, 0);
+    }
+#endif
+    this->sockets.clear();
+    this->workers.clear();
+}
+
+bool physics::DomainCoordinator::step()
+{
+#ifdef __linux__
+    if (this->sockets.empty())
+    {
+        return false;
+    }
+
+    this->computeOwners();
+
+    // all workers get their frame first so they simulate at the same time
+    for (int i = 0; i < this->domains.size(); i++)
+    {
+        this->packDomain(i);
+        if (!sendMessage(this->sockets[i], this->message))
+        {
+            return false;
+        }
+    }
+    for (int i = 0; i < this->domains.size(); i++)
+    {
+        if (!receiveMessage(this->sockets[i], this->message) || !this->unpackDomain())
+        {
+            return false;
+        }
+    }
+
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        body.update();
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void physics::DomainCoordinator::computeOwners()
+{
+    int ballCount = graphs::Balls.size();
+
+    // balls joined by free springs form one group that is owned as a whole, localIndex holds the union-find parents
+    this->localIndex.resize(ballCount);
+    for (int i = 0; i < ballCount; i++)
+    {
+        this->localIndex[i] = i;
+    }
+    for (graphs::Spring &spring : graphs::Springs)
+    {
+        int a = &spring.ball1 - graphs::Balls.data();
+        int b = &spring.ball2 - graphs::Balls.data();
+        if (a < 0 || a >= ballCount || b < 0 || b >= ballCount)
+        {
+            continue;
+        }
+        while (this->localIndex[a] != a)
+        {
+            a = this->localIndex[a];
+        }
+        while (this->localIndex[b] != b)
+        {
+            b = this->localIndex[b];
+        }
+        this->localIndex[std::max(a, b)] = std::min(a, b);
+    }
+
+    // the group follows the domain of its first ball, a position that is not finite falls in no strip and goes to the first domain
+    this->ballOwners.resize(ballCount);
+    for (int i = 0; i < ballCount; i++)
+    {
+        int root = i;
+        while (this->localIndex[root] != root)
+        {
+            root = this->localIndex[root];
+        }
+        if (root < i)
+        {
+            this->ballOwners[i] = this->ballOwners[root];
+            continue;
+        }
+        this->ballOwners[i] = 0;
+        for (int j = 0; j < this->domains.size(); j++)
+        {
+            if (this->domains[j].owns(graphs::Balls[i].pos))
+            {
+                this->ballOwners[i] = j;
+                break;
+            }
+        }
+    }
+
+    // a soft body is never split, it follows the domain of its center
+    this->bodyOwners.resize(graphs::SoftBodys.size());
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        this->bodyOwners[i] = 0;
+        for (int j = 0; j < this->domains.size(); j++)
+        {
+            if (this->domains[j].owns(graphs::SoftBodys[i].center))
+            {
+                this->bodyOwners[i] = j;
+                break;
+            }
+        }
+    }
+}
+
+void physics::DomainCoordinator::packDomain(int domain)
+{
+    const Domain &strip = this->domains[domain];
+    FrameHeader header = {0, 0, 0};
+
+    this->message.clear();
+    writeValue(this->message, header);
+
+    // owned balls first, then the ghosts in the halo
+    this->localIndex.assign(graphs::Balls.size(), -1);
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        if (this->ballOwners[i] == domain)
+        {
+            writeValue(this->message, makeBallState(graphs::Balls[i], i, false));
+            this->localIndex[i] = header.ballCount++;
+        }
+    }
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        const graphs::Ball &ball = graphs::Balls[i];
+        if (this->ballOwners[i] != domain && strip.touches(linalg::AABB::fromCircle(ball.pos, ball.radius)))
+        {
+            writeValue(this->message, makeBallState(ball, i, true));
+            this->localIndex[i] = header.ballCount++;
+        }
+    }
+
+    // springs with both ends in the message, the ones of owned groups and the ones between ghosts
+    for (graphs::Spring &spring : graphs::Springs)
+    {
+        int a = &spring.ball1 - graphs::Balls.data();
+        int b = &spring.ball2 - graphs::Balls.data();
+        if (a < 0 || a >= graphs::Balls.size() || b < 0 || b >= graphs::Balls.size() || this->localIndex[a] < 0 || this->localIndex[b] < 0)
+        {
+            continue;
+        }
+        writeValue(this->message, physics::SpringState{this->localIndex[a], this->localIndex[b], spring.normalLength, spring.springCoefficient});
+        header.springCount++;
+    }
+
+    // owned bodies and the ghost bodies reaching into the halo
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        const graphs::SoftBody &body = graphs::SoftBodys[i];
+        bool isGhost = this->bodyOwners[i] != domain;
+        if (isGhost)
+        {
+            linalg::AABB box(body.cornerBalls[0].pos, body.cornerBalls[0].pos);
+            for (const graphs::Ball &ball : body.cornerBalls)
+            {
+                box = box.merge(linalg::AABB::fromCircle(ball.pos, ball.radius));
+            }
+            if (!strip.touches(box))
+            {
+                continue;
+            }
+        }
+
+        writeValue(this->message, physics::BodyState{body.center.x, body.center.y, body.radius, body.mass, body.elasticity, body.springStiffness, body.pressureStiffness, body.pointCount, i, body.isBeingDragged, isGhost});
+        for (const graphs::Ball &ball : body.cornerBalls)
+        {
+            writeValue(this->message, makeBallState(ball, i, isGhost));
+        }
+        header.bodyCount++;
+    }
+
+    std::memcpy(this->message.data(), &header, sizeof(header));
+}
+
+bool physics::DomainCoordinator::unpackDomain()
+{
+    size_t offset = 0;
+    if (this->message.size() < sizeof(FrameHeader))
+    {
+        return false;
+    }
+    FrameHeader header = readValue<FrameHeader>(this->message, offset);
+
+    for (int i = 0; i < header.ballCount; i++)
+    {
+        physics::BallState state = readValue<physics::BallState>(this->message, offset);
+        applyBallState(graphs::Balls[state.id], state);
+    }
+    for (int i = 0; i < header.bodyCount; i++)
+    {
+        physics::BodyState state = readValue<physics::BodyState>(this->message, offset);
+        graphs::SoftBody &body = graphs::SoftBodys[state.id];
+        for (int j = 0; j < state.pointCount; j++)
+        {
+            applyBallState(body.cornerBalls[j], readValue<physics::BallState>(this->message, offset));
+        }
+    }
+    return true;
+}
+
+void physics::runDomainWorker(int socket, void (*stepWorld)())
+{
+#ifdef __linux__
+    std::vector<char> message;
+    std::vector<physics::BallState> ballStates, lastBallStates, cornerStates;
+    std::vector<physics::BodyState> bodyStates, lastBodyStates;
+    std::vector<physics::SpringState> springStates;
+    std::vector<graphs::SoftBody> bodys;
+    std::vector<int> bodySlots; // local index of every body id of the last frame, -1 if it was not in the domain
+
+    // the forked copy of the scene is not simulated here, the objects of the domain come with the frames
+    graphs::Springs.clear();
+    graphs::SoftBodys.clear();
+    graphs::Balls.clear();
+
+    while (receiveMessage(socket, message))
+    {
+        size_t offset = 0;
+        FrameHeader header = readValue<FrameHeader>(message, offset);
+
+        ballStates.clear();
+        for (int i = 0; i < header.ballCount; i++)
+        {
+            ballStates.push_back(readValue<physics::BallState>(message, offset));
+        }
+        springStates.clear();
+        for (int i = 0; i < header.springCount; i++)
+        {
+            springStates.push_back(readValue<physics::SpringState>(message, offset));
+        }
+        bodyStates.clear();
+        cornerStates.clear();
+        for (int i = 0; i < header.bodyCount; i++)
+        {
+            physics::BodyState state = readValue<physics::BodyState>(message, offset);
+            bodyStates.push_back(state);
+            for (int j = 0; j < state.pointCount; j++)
+            {
+                cornerStates.push_back(readValue<physics::BallState>(message, offset));
+            }
+        }
+
+        // the objects are kept between frames, the balls and their springs are only rebuilt when particles enter or leave the domain
+        if (!isSameLayout(ballStates, lastBallStates) || springStates.size() != graphs::Springs.size())
+        {
+            // springs keep references to the balls, so they are cleared first and the storage is reserved up front
+            graphs::Springs.clear();
+            graphs::Balls.clear();
+            graphs::Balls.reserve(ballStates.size());
+            graphs::Springs.reserve(springStates.size());
+            for (const physics::BallState &state : ballStates)
+            {
+                graphs::Balls.emplace_back(linalg::Vector(state.x, state.y), sf::Color::White, state.radius, state.mass, state.elasticity);
+            }
+            for (const physics::SpringState &state : springStates)
+            {
+                graphs::Springs.emplace_back(graphs::Balls[state.ball1], graphs::Balls[state.ball2], state.normalLength, state.springCoefficient);
+            }
+            lastBallStates = ballStates;
+        }
+        for (int i = 0; i < ballStates.size(); i++)
+        {
+            syncBallState(graphs::Balls[i], ballStates[i]);
+        }
+
+        // bodies that stay in the domain are moved to their new place, only the ones entering it are built
+        if (!isSameLayout(bodyStates, lastBodyStates))
+        {
+            bodys.clear();
+            bodys.reserve(bodyStates.size());
+            for (const physics::BodyState &state : bodyStates)
+            {
+                int slot = (state.id >= 0 && state.id < bodySlots.size()) ? bodySlots[state.id] : -1;
+                if (slot >= 0 && graphs::SoftBodys[slot].pointCount == state.pointCount)
+                {
+                    bodys.push_back(std::move(graphs::SoftBodys[slot]));
+                }
+                else
+                {
+                    bodys.emplace_back(linalg::Vector(state.x, state.y), sf::Color::White, state.pointCount, state.radius, state.mass, state.elasticity, state.springStiffness, state.pressureStiffness);
+                }
+            }
+            graphs::SoftBodys.swap(bodys);
+            for (graphs::SoftBody &body : graphs::SoftBodys)
+            {
+                for (graphs::Spring &spring : body.edgeSprings)
+                {
+                    spring.body = std::ref(body);
+                }
+            }
+
+            for (const physics::BodyState &state : lastBodyStates)
+            {
+                if (state.id >= 0)
+                {
+                    bodySlots[state.id] = -1;
+                }
+            }
+            for (int i = 0; i < bodyStates.size(); i++)
+            {
+                if (bodyStates[i].id < 0)
+                {
+                    continue;
+                }
+                if (bodyStates[i].id >= bodySlots.size())
+                {
+                    bodySlots.resize(bodyStates[i].id + 1, -1);
+                }
+                bodySlots[bodyStates[i].id] = i;
+            }
+            lastBodyStates = bodyStates;
+        }
+        int corner = 0;
+        for (int i = 0; i < bodyStates.size(); i++)
+        {
+            graphs::SoftBody &body = graphs::SoftBodys[i];
+            body.isBeingDragged = bodyStates[i].isBeingDragged;
+            for (graphs::Ball &ball : body.cornerBalls)
+            {
+                syncBallState(ball, cornerStates[corner++]);
+            }
+            body.update();
+        }
+
+        stepWorld();
+
+        // sends back the owned particles only
+        header = {0, 0, 0};
+        message.clear();
+        writeValue(message, header);
+        for (int i = 0; i < ballStates.size(); i++)
+        {
+            if (!ballStates[i].isGhost)
+            {
+                writeValue(message, makeBallState(graphs::Balls[i], ballStates[i].id, false));
+                header.ballCount++;
+            }
+        }
+        for (int i = 0; i < bodyStates.size(); i++)
+        {
+            if (bodyStates[i].isGhost)
+            {
+                continue;
+            }
+            writeValue(message, bodyStates[i]);
+            for (const graphs::Ball &ball : graphs::SoftBodys[i].cornerBalls)
+            {
+                writeValue(message, makeBallState(ball, bodyStates[i].id, false));
+            }
+            header.bodyCount++;
+        }
+        std::memcpy(message.data(), &header, sizeof(header));
+
+        if (!sendMessage(socket, message))
+        {
+            break;
+        }
+    }
+    close(socket);
+#endif
+}
@@ -0,0 +1,165 @@
+#include "../../include/physics/ensemble.hpp"
+#include "../../include/physics/physics.hpp"
+#include "../../include/physics/simulation.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// header of the output file, followed by one record per run in the order they finish
+struct EnsembleFileHeader
+{
+    char magic[4];
+    std::int32_t recordSize;
+};
+
+// adds the energy and speed of a ball to the record
+static void measureBall(const graphs::Ball &ball, const linalg::AABB &bounds, physics::EnsembleRecord &record)
+{
+    float speed = ball.vel.magnitude();
+    record.kineticEnergy += 0.5f * ball.mass * std::pow(speed / physics::PIXEL_PER_METER, 2);
+    record.potentialEnergy += ball.mass * physics::g * (bounds.max.y - ball.pos.y) / physics::PIXEL_PER_METER;
+    record.maxSpeed = std::max(record.maxSpeed, speed);
+}
+
+physics::Ensemble::Ensemble(const graphs::Scene &scene, int runs, int frames, int threadCount, unsigned seed)
+    : scene(scene),
+      min({0.1f, 0.1f, 0.f, 0.f, 0.f}),
+      max({0.9f, 0.8f, 0.05f, 0.5f, 1.f}),
+      runs(runs),
+      frames(frames),
+      threadCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+      seed(seed)
+{
+}
+
+physics::EnsembleParameters physics::Ensemble::sample(int run) const
+{
+    // every run has its own generator, so the parameters do not depend on the thread that runs it
+    std::mt19937 gen(this->seed + run);
+    std::uniform_real_distribution<float> distrib(0.f, 1.f);
+
+    return {this->min.elasticity + (this->max.elasticity - this->min.elasticity) * distrib(gen),
+            this->min.springStiffness + (this->max.springStiffness - this->min.springStiffness) * distrib(gen),
+            this->min.pressureStiffness + (this->max.pressureStiffness - this->min.pressureStiffness) * distrib(gen),
+            this->min.frictionCoefficient + (this->max.frictionCoefficient - this->min.frictionCoefficient) * distrib(gen),
+            this->min.dragCoefficient + (this->max.dragCoefficient - this->min.dragCoefficient) * distrib(gen)};
+}
+
+physics::EnsembleRecord physics::Ensemble::simulate(int run) const
+{
+    EnsembleParameters parameters = this->sample(run);
+
+    // runtime constants of this thread's world
+    physics::frictionCoefficient = parameters.frictionCoefficient;
+    physics::dragCoefficient = parameters.dragCoefficient;
+
+    this->scene.load();
+    for (graphs::Ball &ball : graphs::Balls)
+    {
+        ball.elasticity = parameters.elasticity;
+    }
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        body.elasticity = parameters.elasticity;
+        body.springStiffness = parameters.springStiffness;
+        body.pressureStiffness = parameters.pressureStiffness;
+        for (graphs::Ball &ball : body.cornerBalls)
+        {
+            ball.elasticity = parameters.elasticity;
+        }
+        for (graphs::Spring &spring : body.edgeSprings)
+        {
+            spring.springCoefficient = parameters.springStiffness;
+        }
+    }
+
+    for (int frame = 0; frame < this->frames; frame++)
+    {
+        physics::step();
+    }
+
+    // summary of the final state
+    EnsembleRecord record = {run, parameters, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    const linalg::AABB &bounds = graphs::World.bounds;
+    int count = 0;
+    for (const graphs::Ball &ball : graphs::Balls)
+    {
+        measureBall(ball, bounds, record);
+        record.meanX += ball.pos.x;
+        record.meanY += ball.pos.y;
+        count++;
+    }
+    for (const graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        for (const graphs::Ball &ball : body.cornerBalls)
+        {
+            measureBall(ball, bounds, record);
+        }
+        record.meanX += body.center.x;
+        record.meanY += body.center.y;
+        record.areaError = std::max(record.areaError, std::abs(body.getCurrentArea() - body.restArea) / body.restArea);
+        count++;
+    }
+    if (count > 0)
+    {
+        record.meanX /= count;
+        record.meanY /= count;
+    }
+
+    return record;
+}
+
+bool physics::Ensemble::run(const std::string &path) const
+{
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    EnsembleFileHeader header = {{'E', 'N', 'S', '1'}, sizeof(EnsembleRecord)};
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        std::fclose(file);
+        return false;
+    }
+
+    std::atomic<int> nextRun(0);
+    std::mutex fileMutex;
+    bool isWritten = true; // guarded by fileMutex, the runs stop after the first failed write
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < this->threadCount; i++)
+    {
+        threads.emplace_back([this, &nextRun, &fileMutex, &isWritten, file]()
+                             {
+                                 // every thread has its own balls, springs and soft bodys, the static world is shared
+                                 for (int run = nextRun++; run < this->runs; run = nextRun++)
+                                 {
+                                     EnsembleRecord record = this->simulate(run);
+
+                                     std::lock_guard<std::mutex> lock(fileMutex);
+                                     if (!isWritten)
+                                     {
+                                         return;
+                                     }
+                                     isWritten = std::fwrite(&record, sizeof(record), 1, file) == 1;
+                                 }
+                             });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    // a buffered write can fail only when it is flushed, fclose reports it
+    isWritten = isWritten && std::ferror(file) == 0;
+    return std::fclose(file) == 0 && isWritten;
+}
@@ -0,0 +1,80 @@
+#include "../../include/physics/frame-arena.hpp"
+#include <algorithm>
+#include <memory>
+
+thread_local physics::FrameArena physics::frameArena;
+
+physics::FrameArena::FrameArena(std::size_t capacity)
+    : capacity(capacity),
+      used(0),
+      highWater(0),
+      blockCount(1),
+      blockUsed(0)
+{
+    this->blocks.reserve(8);
+    this->blockSizes.reserve(8);
+    this->blocks.emplace_back(new std::byte[capacity]);
+    this->blockSizes.push_back(capacity);
+}
+
+void *physics::FrameArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    void *memory = this->blocks.back().get() + this->blockUsed;
+    std::size_t space = this->blockSizes.back() - this->blockUsed;
+
+    // a frame that does not fit gets an extra block, this allocates only until the blocks are merged at the next reset
+    if (std::align(alignment, bytes, memory, space) == nullptr)
+    {
+        this->used += space; // the rest of the old block is lost
+        std::size_t size = std::max(bytes + alignment, this->blockSizes.back() * 2);
+        this->blocks.emplace_back(new std::byte[size]);
+        this->blockSizes.push_back(size);
+        this->blockCount++;
+        this->capacity += size;
+        this->blockUsed = 0;
+
+        memory = this->blocks.back().get();
+        space = size;
+        std::align(alignment, bytes, memory, space);
+    }
+
+    std::size_t end = this->blockSizes.back() - space + bytes;
+    this->used += end - this->blockUsed;
+    this->blockUsed = end;
+    this->highWater = std::max(this->highWater, this->used);
+    return memory;
+}
+
+void physics::FrameArena::reset()
+{
+    if (this->blockCount > 1)
+    {
+        // one block large enough for the largest frame so far
+        this->blocks.clear();
+        this->blockSizes.clear();
+        this->capacity = this->highWater * 2;
+        this->blocks.emplace_back(new std::byte[this->capacity]);
+        this->blockSizes.push_back(this->capacity);
+        this->blockCount = 1;
+    }
+    this->used = 0;
+    this->blockUsed = 0;
+}
+
+physics::ArenaScope::ArenaScope(FrameArena &arena)
+    : arena(arena),
+      used(arena.used),
+      blockUsed(arena.blockUsed),
+      blockCount(arena.blockCount)
+{
+}
+
+physics::ArenaScope::~ArenaScope()
+{
+    // blocks added inside the scope stay until the next reset
+    if (this->arena.blockCount == this->blockCount)
+    {
+        this->arena.used = this->used;
+        this->arena.blockUsed = this->blockUsed;
+    }
+}
@@ -0,0 +1,279 @@
+#include "../../include/physics/golden.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+// header of a trajectory file, followed by the states
+struct TrajectoryFileHeader
+{
+    char magic[4];
+    std::uint32_t seed;
+    std::int32_t numberOfBalls, numberOfSoftBodys, frames, particleCount;
+};
+
+static void appendState(const graphs::Ball &ball, std::vector<float> &states)
+{
+    states.push_back(ball.pos.x);
+    states.push_back(ball.pos.y);
+    states.push_back(ball.vel.x);
+    states.push_back(ball.vel.y);
+}
+
+physics::Trajectory::Trajectory(unsigned seed, int numberOfBalls, int numberOfSoftBodys)
+    : seed(seed),
+      numberOfBalls(numberOfBalls),
+      numberOfSoftBodys(numberOfSoftBodys),
+      frames(0),
+      particleCount(0)
+{
+}
+
+void physics::Trajectory::record(int frames, void (*step)())
+{
+    graphs::Scene::random(this->seed, this->numberOfBalls, this->numberOfSoftBodys).load();
+
+    this->frames = frames;
+    this->particleCount = graphs::Balls.size();
+    for (const graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        this->particleCount += body.cornerBalls.size();
+    }
+
+    this->states.clear();
+    this->states.reserve(static_cast<size_t>(frames) * this->particleCount * 4);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        step();
+
+        for (const graphs::Ball &ball : graphs::Balls)
+        {
+            appendState(ball, this->states);
+        }
+        for (const graphs::SoftBody &body : graphs::SoftBodys)
+        {
+            for (const graphs::Ball &ball : body.cornerBalls)
+            {
+                appendState(ball, this->states);
+            }
+        }
+    }
+}
+
+bool physics::Trajectory::save(const std::string &path) const
+{
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    TrajectoryFileHeader header = {{'G', 'L', 'D', '1'}, this->seed, this->numberOfBalls, this->numberOfSoftBodys, this->frames, this->particleCount};
+    bool isWritten = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                     std::fwrite(this->states.data(), sizeof(float), this->states.size(), file) == this->states.size();
+
+    return std::fclose(file) == 0 && isWritten;
+}
+
+bool physics::Trajectory::load(const std::string &path)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    TrajectoryFileHeader header;
+    bool isRead = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  header.magic[0] == 'G' && header.magic[1] == 'L' && header.magic[2] == 'D' && header.magic[3] == '1';
+    if (isRead)
+    {
+        this->seed = header.seed;
+        this->numberOfBalls = header.numberOfBalls;
+        this->numberOfSoftBodys = header.numberOfSoftBodys;
+        this->frames = header.frames;
+        this->particleCount = header.particleCount;
+        this->states.resize(static_cast<size_t>(this->frames) * this->particleCount * 4);
+        isRead = std::fread(this->states.data(), sizeof(float), this->states.size(), file) == this->states.size();
+    }
+
+    std::fclose(file);
+    return isRead;
+}
+
+std::string physics::Trajectory::describeParticle(int particle) const
+{
+    if (particle < this->numberOfBalls)
+    {
+        return "ball " + std::to_string(particle);
+    }
+
+    // every soft body of a random scene has the same number of corners
+    int corners = (this->numberOfSoftBodys > 0) ? (this->particleCount - this->numberOfBalls) / this->numberOfSoftBodys : 1;
+    int corner = particle - this->numberOfBalls;
+    return "body " + std::to_string(corner / corners) + " corner " + std::to_string(corner % corners);
+}
+
+std::string physics::Trajectory::describeObject(int object) const
+{
+    if (object < this->numberOfBalls)
+    {
+        return "ball " + std::to_string(object);
+    }
+    return "body " + std::to_string(object - this->numberOfBalls);
+}
+
+physics::Divergence physics::compareTrajectories(const Trajectory &reference, const Trajectory &candidate, const Tolerances &tolerances)
+{
+    Divergence divergence = {false, -1, -1, "", "", 0.f, 0.f, 0.f, "", -1, 0.f};
+
+    if (reference.particleCount != candidate.particleCount || reference.frames != candidate.frames)
+    {
+        divergence.hasDiverged = true;
+        divergence.quantity = "scene size";
+        return divergence;
+    }
+
+    double squaredSum = 0.0;
+    for (int frame = 0; frame < reference.frames; frame++)
+    {
+        for (int particle = 0; particle < reference.particleCount; particle++)
+        {
+            size_t index = (static_cast<size_t>(frame) * reference.particleCount + particle) * 4;
+            const float *expected = &reference.states[index];
+            const float *actual = &candidate.states[index];
+
+            float positionError = std::hypot(actual[0] - expected[0], actual[1] - expected[1]);
+            float velocityError = std::hypot(actual[2] - expected[2], actual[3] - expected[3]);
+
+            squaredSum += positionError * positionError;
+            divergence.maxPositionDrift = std::max(divergence.maxPositionDrift, positionError);
+            if (!(positionError <= divergence.worstPositionError))
+            {
+                divergence.worstObject = reference.describeParticle(particle);
+                divergence.worstFrame = frame;
+                divergence.worstPositionError = positionError;
+            }
+
+            // NaN never passes a tolerance
+            bool isPositionOff = !(positionError <= tolerances.position);
+            bool isVelocityOff = !(velocityError <= tolerances.velocity);
+            if (!divergence.hasDiverged && (isPositionOff || isVelocityOff))
+            {
+                divergence.hasDiverged = true;
+                divergence.frame = frame;
+                divergence.particle = particle;
+                divergence.object = reference.describeParticle(particle);
+                divergence.quantity = isPositionOff ? "position" : "velocity";
+                divergence.error = isPositionOff ? positionError : velocityError;
+            }
+        }
+    }
+
+    size_t samples = static_cast<size_t>(reference.frames) * reference.particleCount;
+    divergence.rmsPositionDrift = (samples > 0) ? std::sqrt(squaredSum / samples) : 0.f;
+
+    return divergence;
+}
+
+physics::Divergence physics::compareObjects(const Trajectory &reference, const Trajectory &candidate, const Tolerances &tolerances, int horizon, float percentile)
+{
+    Divergence divergence = {false, -1, -1, "", "", 0.f, 0.f, 0.f, "", -1, 0.f};
+
+    if (reference.particleCount != candidate.particleCount || reference.frames != candidate.frames)
+    {
+        divergence.hasDiverged = true;
+        divergence.quantity = "scene size";
+        return divergence;
+    }
+
+    int objectCount = reference.numberOfBalls + reference.numberOfSoftBodys;
+    int corners = (reference.numberOfSoftBodys > 0) ? (reference.particleCount - reference.numberOfBalls) / reference.numberOfSoftBodys : 1;
+    int comparedFrames = std::min(horizon, reference.frames);
+
+    // the largest error of every object over the horizon, NaN counts as infinite
+    std::vector<float> positionErrors(objectCount, 0.f), velocityErrors(objectCount, 0.f);
+    double squaredSum = 0.0;
+    for (int frame = 0; frame < comparedFrames; frame++)
+    {
+        const float *expectedFrame = &reference.states[static_cast<size_t>(frame) * reference.particleCount * 4];
+        const float *actualFrame = &candidate.states[static_cast<size_t>(frame) * reference.particleCount * 4];
+
+        for (int object = 0; object < objectCount; object++)
+        {
+            // a loose ball is one particle, a body is the mean of its corners
+            int first = (object < reference.numberOfBalls) ? object : reference.numberOfBalls + (object - reference.numberOfBalls) * corners;
+            int count = (object < reference.numberOfBalls) ? 1 : corners;
+            float expected[4] = {0.f, 0.f, 0.f, 0.f};
+            float actual[4] = {0.f, 0.f, 0.f, 0.f};
+            for (int particle = first; particle < first + count; particle++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    expected[i] += expectedFrame[particle * 4 + i] / count;
+                    actual[i] += actualFrame[particle * 4 + i] / count;
+                }
+            }
+
+            float positionError = std::hypot(actual[0] - expected[0], actual[1] - expected[1]);
+            float velocityError = std::hypot(actual[2] - expected[2], actual[3] - expected[3]);
+            positionError = std::isnan(positionError) ? INFINITY : positionError;
+            velocityError = std::isnan(velocityError) ? INFINITY : velocityError;
+
+            squaredSum += positionError * positionError;
+            positionErrors[object] = std::max(positionErrors[object], positionError);
+            velocityErrors[object] = std::max(velocityErrors[object], velocityError);
+            if (positionError > divergence.worstPositionError)
+            {
+                divergence.worstObject = reference.describeObject(object);
+                divergence.worstFrame = frame;
+                divergence.worstPositionError = positionError;
+            }
+        }
+    }
+
+    size_t samples = static_cast<size_t>(comparedFrames) * objectCount;
+    divergence.maxPositionDrift = divergence.worstPositionError;
+    divergence.rmsPositionDrift = (samples > 0) ? std::sqrt(squaredSum / samples) : 0.f;
+
+    // a few objects that met another island or domain in another order part early, the rest has to stay close
+    if (objectCount > 0)
+    {
+        int rank = std::min(objectCount - 1, static_cast<int>(percentile * objectCount));
+        std::nth_element(positionErrors.begin(), positionErrors.begin() + rank, positionErrors.end());
+        std::nth_element(velocityErrors.begin(), velocityErrors.begin() + rank, velocityErrors.end());
+        bool isPositionOff = !(positionErrors[rank] <= tolerances.position);
+        bool isVelocityOff = !(velocityErrors[rank] <= tolerances.velocity);
+        if (isPositionOff || isVelocityOff)
+        {
+            divergence.hasDiverged = true;
+            divergence.frame = comparedFrames - 1;
+            divergence.object = "percentile " + std::to_string(static_cast<int>(percentile * 100.f)) + " of the objects";
+            divergence.quantity = isPositionOff ? "position" : "velocity";
+            divergence.error = isPositionOff ? positionErrors[rank] : velocityErrors[rank];
+        }
+    }
+
+    // after the horizon the paths part, a step that blows up still fails
+    for (int frame = 0; frame < reference.frames && !divergence.hasDiverged; frame++)
+    {
+        const float *actualFrame = &candidate.states[static_cast<size_t>(frame) * reference.particleCount * 4];
+        for (int i = 0; i < reference.particleCount * 4; i++)
+        {
+            if (!std::isfinite(actualFrame[i]))
+            {
+                divergence.hasDiverged = true;
+                divergence.frame = frame;
+                divergence.particle = i / 4;
+                divergence.object = reference.describeParticle(i / 4);
+                divergence.quantity = "finite state";
+                divergence.error = actualFrame[i];
+                break;
+            }
+        }
+    }
+
+    return divergence;
+}
@@ -0,0 +1,261 @@
+#include "../../include/physics/metrics.hpp"
+#include "../../include/physics/physics.hpp"
+#include "../../include/physics/allocation-counter.hpp"
+#include "../../include/physics/frame-arena.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/rope.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+thread_local physics::Metrics physics::metrics;
+
+// below this many objects per thread the reduction runs on the calling thread
+static const int MIN_REDUCTION_CHUNK = 4096;
+
+// partial sums of one chunk
+struct EnergySums
+{
+    float kinetic, potential, spring, areaError;
+};
+
+static void addBallEnergy(const graphs::Ball &ball, float floor, float gravity, EnergySums &sums)
+{
+    float speedInMeter = ball.vel.magnitude() / physics::PIXEL_PER_METER;
+    sums.kinetic += 0.5f * ball.mass * speedInMeter * speedInMeter;
+    sums.potential += ball.mass * gravity * (floor - ball.pos.y) / physics::PIXEL_PER_METER;
+}
+
+// sums loose balls and free springs in [first, last) of the combined index range
+// the world is passed in, the containers and the gravity are thread_local and empty on the reduction threads
+static void reduceLoose(const std::vector<graphs::Ball> &balls, const std::vector<graphs::Spring> &springs, int first, int last, float floor, float gravity, EnergySums &sums)
+{
+    int ballCount = balls.size();
+    for (int i = first; i < last; i++)
+    {
+        if (i < ballCount)
+        {
+            addBallEnergy(balls[i], floor, gravity, sums);
+        }
+        else
+        {
+            sums.spring += springs[i - ballCount].potentialEnergy;
+        }
+    }
+}
+
+static void reduceBodys(const std::vector<graphs::SoftBody> &bodys, int first, int last, float floor, float gravity, EnergySums &sums)
+{
+    for (int i = first; i < last; i++)
+    {
+        const graphs::SoftBody &body = bodys[i];
+        for (const graphs::Ball &ball : body.cornerBalls)
+        {
+            addBallEnergy(ball, floor, gravity, sums);
+        }
+        for (const graphs::Spring &spring : body.edgeSprings)
+        {
+            sums.spring += spring.potentialEnergy;
+        }
+        if (body.restArea > 0.f)
+        {
+            sums.areaError = std::max(sums.areaError, std::abs(body.getCurrentArea() - body.restArea) / body.restArea);
+        }
+    }
+}
+
+physics::Metrics::Metrics()
+    : pairs(0),
+      contacts(0),
+      subSteps(0),
+      allocations(0),
+      frames(0),
+      totalPairs(0),
+      totalContacts(0),
+      totalSubSteps(0),
+      totalAllocations(0),
+      stepMilliseconds(0.f),
+      kineticEnergy(0.f),
+      potentialEnergy(0.f),
+      springEnergy(0.f),
+      areaError(0.f),
+      format(MetricsFormat::Prometheus),
+      sampleInterval(60),
+      reductionThreads(0),
+      allocationsAtStart(0)
+{
+}
+
+void physics::Metrics::beginStep()
+{
+    this->pairs = 0;
+    this->contacts = 0;
+    this->subSteps = 0;
+    this->stepStart = std::chrono::steady_clock::now();
+    this->allocationsAtStart = physics::allocationCount();
+}
+
+void physics::Metrics::endStep()
+{
+    this->stepMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - this->stepStart).count();
+    this->allocations = physics::allocationCount() - this->allocationsAtStart;
+
+    this->frames++;
+    this->totalPairs += this->pairs;
+    this->totalContacts += this->contacts;
+    this->totalSubSteps += this->subSteps;
+    this->totalAllocations += this->allocations;
+
+    // the reductions and the export only run on sampled frames
+    if (this->sampleInterval > 0 && this->frames % this->sampleInterval == 0)
+    {
+        this->sample();
+        this->write();
+    }
+}
+
+void physics::Metrics::sample()
+{
+    const std::vector<graphs::Ball> &balls = graphs::Balls;
+    const std::vector<graphs::Spring> &springs = graphs::Springs;
+    const std::vector<graphs::SoftBody> &bodys = graphs::SoftBodys;
+    float floor = graphs::World.bounds.max.y;
+    float gravity = physics::g;
+    int looseCount = balls.size() + springs.size();
+    int bodyCount = bodys.size();
+
+    // soft bodys hold many balls each, so they are weighted by their size
+    int bodyObjects = 0;
+    for (const graphs::SoftBody &body : bodys)
+    {
+        bodyObjects += body.cornerBalls.size() + body.edgeSprings.size();
+    }
+
+    int maxThreads = (this->reductionThreads > 0) ? this->reductionThreads : std::max(1u, std::thread::hardware_concurrency());
+    int threadCount = std::min<int>(maxThreads, (looseCount + bodyObjects) / MIN_REDUCTION_CHUNK + 1);
+    physics::ArenaScope scope;
+    physics::FrameVector<EnergySums> sums(threadCount, EnergySums{0.f, 0.f, 0.f, 0.f});
+
+    if (threadCount == 1)
+    {
+        reduceLoose(balls, springs, 0, looseCount, floor, gravity, sums[0]);
+        reduceBodys(bodys, 0, bodyCount, floor, gravity, sums[0]);
+    }
+    else
+    {
+        // every thread reduces its own slice of each range, the partial sums are combined below
+        // starting a thread allocates its state, this path is only taken for very large scenes
+        physics::FrameVector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&sums, &balls, &springs, &bodys, i, threadCount, looseCount, bodyCount, floor, gravity]()
+                                 {
+                                     reduceLoose(balls, springs, looseCount * i / threadCount, looseCount * (i + 1) / threadCount, floor, gravity, sums[i]);
+                                     reduceBodys(bodys, bodyCount * i / threadCount, bodyCount * (i + 1) / threadCount, floor, gravity, sums[i]);
+                                 });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // ropes are summed on the calling thread, their links are light
+    for (const graphs::Rope &rope : graphs::Ropes)
+    {
+        for (const graphs::Ball &link : rope.links)
+        {
+            addBallEnergy(link, floor, gravity, sums[0]);
+        }
+    }
+
+    this->kineticEnergy = 0.f;
+    this->potentialEnergy = 0.f;
+    this->springEnergy = 0.f;
+    this->areaError = 0.f;
+    for (const EnergySums &partial : sums)
+    {
+        this->kineticEnergy += partial.kinetic;
+        this->potentialEnergy += partial.potential;
+        this->springEnergy += partial.spring;
+        this->areaError = std::max(this->areaError, partial.areaError);
+    }
+}
+
+bool physics::Metrics::write() const
+{
+    if (this->path.empty())
+    {
+        return false;
+    }
+
+    if (this->format == MetricsFormat::LineProtocol)
+    {
+        std::FILE *file = std::fopen(this->path.c_str(), "a");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        long long timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        std::fprintf(file, "physics step_ms=%f,pairs=%lldi,contacts=%lldi,sub_steps=%lldi,frames=%lldi,kinetic_energy=%f,potential_energy=%f,spring_energy=%f,area_error=%f",
+                     this->stepMilliseconds, this->pairs, this->contacts, this->subSteps, this->frames,
+                     this->kineticEnergy, this->potentialEnergy, this->springEnergy, this->areaError);
+        if (physics::isCountingAllocations())
+        {
+            std::fprintf(file, ",allocations=%lldi,allocations_total=%lldi", this->allocations, this->totalAllocations);
+        }
+        std::fprintf(file, " %lld\n", timestamp);
+        return std::fclose(file) == 0;
+    }
+
+    // written next to the file and renamed, so a scraper never reads half of it
+    // the name is built on the stack, a sampled frame does not allocate
+    char temporaryPath[4096];
+    if (std::snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", this->path.c_str()) >= sizeof(temporaryPath))
+    {
+        return false;
+    }
+    std::FILE *file = std::fopen(temporaryPath, "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    std::fprintf(file,
+                 "# TYPE physics_frames_total counter\nphysics_frames_total %lld\n"
+                 "# TYPE physics_pairs_total counter\nphysics_pairs_total %lld\n"
+                 "# TYPE physics_contacts_total counter\nphysics_contacts_total %lld\n"
+                 "# TYPE physics_sub_steps_total counter\nphysics_sub_steps_total %lld\n"
+                 "# TYPE physics_step_milliseconds gauge\nphysics_step_milliseconds %f\n"
+                 "# TYPE physics_pairs gauge\nphysics_pairs %lld\n"
+                 "# TYPE physics_contacts gauge\nphysics_contacts %lld\n"
+                 "# TYPE physics_kinetic_energy_joules gauge\nphysics_kinetic_energy_joules %f\n"
+                 "# TYPE physics_potential_energy_joules gauge\nphysics_potential_energy_joules %f\n"
+                 "# TYPE physics_spring_energy_joules gauge\nphysics_spring_energy_joules %f\n"
+                 "# TYPE physics_area_error_ratio gauge\nphysics_area_error_ratio %f\n",
+                 this->frames, this->totalPairs, this->totalContacts, this->totalSubSteps,
+                 this->stepMilliseconds, this->pairs, this->contacts,
+                 this->kineticEnergy, this->potentialEnergy, this->springEnergy, this->areaError);
+    if (physics::isCountingAllocations())
+    {
+        std::fprintf(file,
+                     "# TYPE physics_allocations_total counter\nphysics_allocations_total %lld\n"
+                     "# TYPE physics_allocations gauge\nphysics_allocations %lld\n",
+                     this->totalAllocations, this->allocations);
+    }
+    if (std::fclose(file) != 0)
+    {
+        return false;
+    }
+    if (std::rename(temporaryPath, this->path.c_str()) != 0)
+    {
+        // rename does not replace an existing file on every platform
+        std::remove(this->path.c_str());
+        return std::rename(temporaryPath, this->path.c_str()) == 0;
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+#include "../../include/physics/morton.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// spreads the lower 16 bits so there is a zero between every two of them
+static unsigned spreadBits(unsigned value)
+{
+    value &= 0x0000ffff;
+    value = (value | (value << 8)) & 0x00ff00ff;
+    value = (value | (value << 4)) & 0x0f0f0f0f;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+unsigned physics::mortonCode(const linalg::Vector &point, const linalg::AABB &bounds)
+{
+    linalg::Vector size = bounds.size();
+    float x = (size.x > 0.f) ? (point.x - bounds.min.x) / size.x : 0.f;
+    float y = (size.y > 0.f) ? (point.y - bounds.min.y) / size.y : 0.f;
+
+    // particles outside the bounds are clamped to its edge
+    unsigned cellX = std::clamp(x, 0.f, 1.f) * 65535.f;
+    unsigned cellY = std::clamp(y, 0.f, 1.f) * 65535.f;
+
+    return spreadBits(cellX) | (spreadBits(cellY) << 1);
+}
+
+physics::MortonOrder::MortonOrder(int minInterval, int maxInterval, float threshold)
+    : interval(minInterval),
+      minInterval(minInterval),
+      maxInterval(maxInterval),
+      threshold(threshold),
+      disorder(0.f),
+      framesSinceCheck(0),
+      reorderCount(0)
+{
+}
+
+float physics::MortonOrder::measure() const
+{
+    // counts neighbours in memory whose codes are not in order, a random order gives about one half
+    const linalg::AABB &bounds = graphs::World.bounds;
+    int count = 0;
+    int outOfOrder = 0;
+
+    for (int i = 0; i + 1 < graphs::Balls.size(); i++)
+    {
+        outOfOrder += physics::mortonCode(graphs::Balls[i].pos, bounds) > physics::mortonCode(graphs::Balls[i + 1].pos, bounds);
+        count++;
+    }
+    for (int i = 0; i + 1 < graphs::SoftBodys.size(); i++)
+    {
+        outOfOrder += physics::mortonCode(graphs::SoftBodys[i].center, bounds) > physics::mortonCode(graphs::SoftBodys[i + 1].center, bounds);
+        count++;
+    }
+
+    return (count > 0) ? static_cast<float>(outOfOrder) / count : 0.f;
+}
+
+bool physics::MortonOrder::update()
+{
+    if (++this->framesSinceCheck < this->interval)
+    {
+        return false;
+    }
+    this->framesSinceCheck = 0;
+    this->disorder = this->measure();
+
+    // checks more often while the particles keep mixing, less often while they stay in place
+    if (this->disorder > this->threshold)
+    {
+        this->reorder();
+        this->interval = std::max(this->minInterval, this->interval / 2);
+        return true;
+    }
+    this->interval = std::min(this->maxInterval, this->interval * 2);
+    return false;
+}
+
+void physics::MortonOrder::reorder()
+{
+    const linalg::AABB &bounds = graphs::World.bounds;
+    std::vector<std::pair<unsigned, int>> &order = this->order;
+
+    // loose balls
+    order.clear();
+    order.reserve(std::max(graphs::Balls.size(), graphs::SoftBodys.size()));
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        order.emplace_back(physics::mortonCode(graphs::Balls[i].pos, bounds), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> &newIndex = this->newIndex;
+    std::vector<graphs::Ball> &balls = this->balls;
+    newIndex.assign(graphs::Balls.size(), 0);
+    balls.clear();
+    balls.reserve(graphs::Balls.size());
+    for (int i = 0; i < order.size(); i++)
+    {
+        newIndex[order[i].second] = i;
+        balls.push_back(std::move(graphs::Balls[order[i].second]));
+    }
+
+    // springs hold references, so they are created again on the moved balls
+    std::vector<graphs::Spring> &springs = this->springs;
+    springs.clear();
+    springs.reserve(graphs::Springs.size());
+    for (const graphs::Spring &spring : graphs::Springs)
+    {
+        int ball1 = &spring.ball1 - graphs::Balls.data();
+        int ball2 = &spring.ball2 - graphs::Balls.data();
+        bool isLoose1 = ball1 >= 0 && ball1 < newIndex.size();
+        bool isLoose2 = ball2 >= 0 && ball2 < newIndex.size();
+
+        graphs::Spring &moved = springs.emplace_back(isLoose1 ? balls[newIndex[ball1]] : spring.ball1, isLoose2 ? balls[newIndex[ball2]] : spring.ball2, spring.normalLength, spring.springCoefficient, spring.color);
+        moved.springForce = spring.springForce;
+        moved.currentLength = spring.currentLength;
+        moved.potentialEnergy = spring.potentialEnergy;
+    }
+    graphs::Balls.swap(balls);
+    graphs::Springs.swap(springs);
+
+    // soft bodys move as a whole, their corner balls keep the order of the ring
+    order.clear();
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        order.emplace_back(physics::mortonCode(graphs::SoftBodys[i].center, bounds), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<graphs::SoftBody> &bodys = this->bodys;
+    bodys.clear();
+    bodys.reserve(graphs::SoftBodys.size());
+    for (const std::pair<unsigned, int> &item : order)
+    {
+        bodys.push_back(std::move(graphs::SoftBodys[item.second]));
+    }
+    graphs::SoftBodys.swap(bodys);
+
+    // moving a body keeps the storage of its balls and springs, only the springs' link to the body changes
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        for (graphs::Spring &spring : body.edgeSprings)
+        {
+            spring.body = std::ref(body);
+        }
+    }
+
+    this->reorderCount++;
+}
@@ -6,9 +6,16 @@ namespace physics{
     const float FIXED_DELTA_TIME = 1.f / 60.f;
     const int SUB_STEPS = 5;
     const float SUB_DELTA_TIME = FIXED_DELTA_TIME / SUB_STEPS;
-    const float g = 9.8f;
     const float pi = 2 * std::acos(0.0f);
-    const float frictionCoefficient = 0.2f;
-    const float dragCoefficient = 0.47f;
-    const float airDensity = 1.225f;
+
+    thread_local float g = 9.8f;
+    thread_local float frictionCoefficient = 0.2f;
+    thread_local float dragCoefficient = 0.47f;
+    thread_local float airDensity = 1.225f;
+
+    const float CCD_MOTION_THRESHOLD = 0.5f;
+    const int CCD_MAX_ITERATIONS = 4;
+    const float CCD_CONTACT_SLOP = 0.5f;
+
+    const float STIFFNESS_STEP = 0.5f;
 }
\ No newline at end of file
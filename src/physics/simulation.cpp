@@ -0,0 +1,756 @@
+#include "../../include/physics/simulation.hpp"
+#include "../../include/physics/physics.hpp"
+#include "../../include/physics/metrics.hpp"
+#include "../../include/physics/spatial-grid.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/rope.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// box of the corner balls of a body
+static linalg::AABB bodyBounds(const graphs::SoftBody &body)
+{
+    linalg::AABB box = linalg::AABB::fromCircle(body.center, 0.f);
+    for (const graphs::Ball &ball : body.cornerBalls)
+    {
+        box = box.merge(linalg::AABB::fromCircle(ball.pos, ball.radius));
+    }
+    return box;
+}
+
+// balls vs the links and segments of a rope, far balls are rejected by the box of the rope
+static void checkRopeCollision(graphs::Ball &ball, graphs::Rope &rope)
+{
+    if (!rope.bounds.overlaps(linalg::AABB::fromCircle(ball.pos, ball.radius)))
+    {
+        return;
+    }
+    for (graphs::Ball &link : rope.links)
+    {
+        ball.checkBallCollision(link);
+    }
+    for (graphs::Spring &segment : rope.segments)
+    {
+        ball.checkSpringCollision(segment);
+    }
+}
+
+// integrates one ball, fast movers are swept so they can not tunnel through thin objects
+static void integrateBall(graphs::Ball &ball, float deltaTime, const graphs::SoftBody *body = nullptr)
+{
+    ball.computeDragForce();
+    ball.computeFrictionForce();
+    ball.checkWallCollision();
+
+    if (ball.isFastMover(deltaTime))
+    {
+        ball.sweptUpdate(deltaTime, body);
+    }
+    else
+    {
+        ball.update(deltaTime);
+    }
+}
+
+// no ball has moved yet when a sub-step starts, the sweeps meet the others on their paths from there
+static void resetStepTimes(std::vector<graphs::Ball> &balls)
+{
+    for (graphs::Ball &ball : balls)
+    {
+        ball.stepTime = 0.f;
+    }
+}
+
+static void resetStepTimes()
+{
+    resetStepTimes(graphs::Balls);
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        resetStepTimes(body.cornerBalls);
+    }
+    for (graphs::Rope &rope : graphs::Ropes)
+    {
+        resetStepTimes(rope.links);
+    }
+}
+
+static void resetForces(std::vector<graphs::Ball> &balls)
+{
+    for (graphs::Ball &ball : balls)
+    {
+        ball.springForce = linalg::Vector(0.f, 0.f);
+        ball.pressureForce = linalg::Vector(0.f, 0.f);
+    }
+}
+
+// the springs and the pressure of a body only pull its own corners
+static void computeBodyForces(graphs::SoftBody &body)
+{
+    for (graphs::Spring &spring : body.edgeSprings)
+    {
+        spring.computeSpringForce();
+    }
+    body.computePressureForce();
+}
+
+static void integrateBody(graphs::SoftBody &body, float deltaTime)
+{
+    for (graphs::Ball &ball : body.cornerBalls)
+    {
+        integrateBall(ball, deltaTime, &body);
+    }
+    body.update(); // update center of body
+}
+
+// SoftBody'nin Kendi İç Çarpışmaları (Top vs Top)
+static void resolveSelfCollisions(graphs::SoftBody &body)
+{
+    for (int i = 0; i < body.cornerBalls.size(); i++)
+    {
+        graphs::Ball &ball1 = body.cornerBalls[i];
+        for (int j = i + 1; j < body.cornerBalls.size(); j++)
+        {
+            graphs::Ball &ball2 = body.cornerBalls[j];
+            ball1.checkBallCollision(ball2);
+        }
+    }
+}
+
+// resets the forces of the links and lets every rope solve itself
+static void updateRopes(float deltaTime)
+{
+    for (graphs::Rope &rope : graphs::Ropes)
+    {
+        resetForces(rope.links);
+        rope.update(deltaTime);
+    }
+}
+
+// items of a ring bucketed by the cell of their center, a cell is as wide as the reach of a contact
+struct RingBuckets
+{
+    linalg::AABB region;
+    float cellSize;
+    int columns, rows;
+    std::vector<int> cellStart, cellItems; // items of cell i are cellItems[cellStart[i]] .. cellItems[cellStart[i + 1]]
+};
+
+// corners and ring edges of two bodys that lie inside the overlap of their boxes
+struct BodyContacts
+{
+    std::vector<int> cornersA, cornersB, edgesA, edgesB;
+    RingBuckets cornerBucketsB, edgeBucketsA, edgeBucketsB;
+    std::vector<int> candidates; // near items of one corner, in ring order
+};
+
+static thread_local BodyContacts bodyContacts;
+
+// collects the corners and the ring edges of a body near the region, edge i joins corner i and corner i + 1
+static void cullRing(graphs::SoftBody &body, const linalg::AABB &region, std::vector<int> &corners, std::vector<int> &edges)
+{
+    corners.clear();
+    edges.clear();
+    int count = body.cornerBalls.size();
+    for (int i = 0; i < count; i++)
+    {
+        const graphs::Ball &start = body.cornerBalls[i];
+        const graphs::Ball &end = body.cornerBalls[(i + 1) % count];
+        if (region.overlaps(linalg::AABB::fromCircle(start.pos, start.radius)))
+        {
+            corners.push_back(i);
+        }
+        if (region.overlaps(linalg::AABB::fromSegment(start.pos, end.pos)))
+        {
+            edges.push_back(i);
+        }
+    }
+}
+
+static int bucketCell(const RingBuckets &buckets, const linalg::Vector &point)
+{
+    int column = std::clamp(static_cast<int>((point.x - buckets.region.min.x) / buckets.cellSize), 0, buckets.columns - 1);
+    int row = std::clamp(static_cast<int>((point.y - buckets.region.min.y) / buckets.cellSize), 0, buckets.rows - 1);
+    return row * buckets.columns + column;
+}
+
+// counting sort of the items by cell, they keep their ring order inside a cell
+template <typename Center>
+static void fillBuckets(RingBuckets &buckets, const linalg::AABB &region, float cellSize, const std::vector<int> &items, Center center)
+{
+    // a region much larger than the items gets larger cells, the table stays about as large as the ring
+    linalg::Vector size = region.size();
+    float minCellSize = std::sqrt(std::max(size.x * size.y, 0.f) / (4.f * items.size() + 1.f));
+    buckets.region = region;
+    buckets.cellSize = std::max(cellSize, minCellSize);
+    buckets.columns = std::max(1, static_cast<int>(size.x / buckets.cellSize) + 1);
+    buckets.rows = std::max(1, static_cast<int>(size.y / buckets.cellSize) + 1);
+
+    int cellCount = buckets.columns * buckets.rows;
+    buckets.cellStart.assign(cellCount + 1, 0);
+    buckets.cellItems.resize(items.size());
+    for (int item : items)
+    {
+        buckets.cellStart[bucketCell(buckets, center(item)) + 1]++;
+    }
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        buckets.cellStart[cell + 1] += buckets.cellStart[cell];
+    }
+    for (int item : items)
+    {
+        buckets.cellItems[buckets.cellStart[bucketCell(buckets, center(item))]++] = item;
+    }
+
+    // the placement moved the start of every cell to its end
+    for (int cell = cellCount; cell > 0; cell--)
+    {
+        buckets.cellStart[cell] = buckets.cellStart[cell - 1];
+    }
+    buckets.cellStart[0] = 0;
+}
+
+// items in the cells around the point, nothing further than a cell can reach it, sorted in ring order so the responses keep their order
+static void collectNear(const RingBuckets &buckets, const linalg::Vector &point, std::vector<int> &result)
+{
+    result.clear();
+    int cell = bucketCell(buckets, point);
+    int column = cell % buckets.columns, row = cell / buckets.columns;
+    for (int y = std::max(row - 1, 0); y <= std::min(row + 1, buckets.rows - 1); y++)
+    {
+        for (int x = std::max(column - 1, 0); x <= std::min(column + 1, buckets.columns - 1); x++)
+        {
+            int near = y * buckets.columns + x;
+            result.insert(result.end(), buckets.cellItems.begin() + buckets.cellStart[near], buckets.cellItems.begin() + buckets.cellStart[near + 1]);
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+// two bodys collide as deformable polygons, the interior springs never touch another body
+static void checkBodyCollision(graphs::SoftBody &bodyA, graphs::SoftBody &bodyB)
+{
+    linalg::AABB boxA = bodyBounds(bodyA);
+    linalg::AABB boxB = bodyBounds(bodyB);
+    if (!boxA.overlaps(boxB))
+    {
+        return;
+    }
+
+    // an edge can touch a corner whose center is a radius outside the overlap
+    float margin = 0.f;
+    for (const graphs::Ball &ball : bodyA.cornerBalls)
+    {
+        margin = std::max(margin, ball.radius);
+    }
+    for (const graphs::Ball &ball : bodyB.cornerBalls)
+    {
+        margin = std::max(margin, ball.radius);
+    }
+    linalg::AABB region = boxA.intersect(boxB).expand(margin);
+
+    BodyContacts &contacts = bodyContacts;
+    cullRing(bodyA, region, contacts.cornersA, contacts.edgesA);
+    cullRing(bodyB, region, contacts.cornersB, contacts.edgesB);
+    int countA = bodyA.cornerBalls.size();
+    int countB = bodyB.cornerBalls.size();
+
+    // a corner reaches two radii to another corner and a radius plus half an edge to the middle of an edge, one radius more covers the pushes of earlier contacts
+    float halfEdge = 0.f;
+    for (int a : contacts.edgesA)
+    {
+        halfEdge = std::max(halfEdge, (bodyA.cornerBalls[(a + 1) % countA].pos - bodyA.cornerBalls[a].pos).magnitude() / 2.f);
+    }
+    for (int b : contacts.edgesB)
+    {
+        halfEdge = std::max(halfEdge, (bodyB.cornerBalls[(b + 1) % countB].pos - bodyB.cornerBalls[b].pos).magnitude() / 2.f);
+    }
+    float cellSize = 2.f * margin + std::max(margin, halfEdge);
+    linalg::AABB bucketRegion = region.expand(cellSize);
+    fillBuckets(contacts.cornerBucketsB, bucketRegion, cellSize, contacts.cornersB, [&bodyB](int b)
+                { return bodyB.cornerBalls[b].pos; });
+    fillBuckets(contacts.edgeBucketsB, bucketRegion, cellSize, contacts.edgesB, [&bodyB, countB](int b)
+                { return (bodyB.cornerBalls[b].pos + bodyB.cornerBalls[(b + 1) % countB].pos) / 2.f; });
+    fillBuckets(contacts.edgeBucketsA, bucketRegion, cellSize, contacts.edgesA, [&bodyA, countA](int a)
+                { return (bodyA.cornerBalls[a].pos + bodyA.cornerBalls[(a + 1) % countA].pos) / 2.f; });
+
+    // balls of body1 vs balls of body2
+    for (int a : contacts.cornersA)
+    {
+        collectNear(contacts.cornerBucketsB, bodyA.cornerBalls[a].pos, contacts.candidates);
+        for (int b : contacts.candidates)
+        {
+            bodyA.cornerBalls[a].checkBallCollision(bodyB.cornerBalls[b]);
+        }
+    }
+
+    // balls of body1 vs ring of body2
+    for (int a : contacts.cornersA)
+    {
+        collectNear(contacts.edgeBucketsB, bodyA.cornerBalls[a].pos, contacts.candidates);
+        for (int b : contacts.candidates)
+        {
+            bodyA.cornerBalls[a].checkEdgeCollision(bodyB.cornerBalls[b], bodyB.cornerBalls[(b + 1) % countB]);
+        }
+    }
+
+    // balls of body2 vs ring of body1
+    for (int b : contacts.cornersB)
+    {
+        collectNear(contacts.edgeBucketsA, bodyB.cornerBalls[b].pos, contacts.candidates);
+        for (int a : contacts.candidates)
+        {
+            bodyB.cornerBalls[b].checkEdgeCollision(bodyA.cornerBalls[a], bodyA.cornerBalls[(a + 1) % countA]);
+        }
+    }
+}
+
+// collisions between different objects
+static void resolveInteractions()
+{
+    // ball vs ball
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        for (int j = i + 1; j < graphs::Balls.size(); j++)
+        {
+            graphs::Balls.at(i).checkBallCollision(graphs::Balls.at(j));
+        }
+    }
+
+    // ball vs body
+    for (graphs::Ball &looseBall : graphs::Balls)
+    {
+        for (graphs::SoftBody &body : graphs::SoftBodys)
+        {
+            // ball vs ball of softbody
+            for (graphs::Ball &cornerBall : body.cornerBalls)
+            {
+                looseBall.checkBallCollision(cornerBall);
+            }
+            // ball vs spring of softbody
+            for (graphs::Spring &spring : body.edgeSprings)
+            {
+                looseBall.checkSpringCollision(spring);
+            }
+        }
+    }
+
+    // balls vs springs
+    for (graphs::Ball &ball : graphs::Balls)
+    {
+        for (graphs::Spring &spring : graphs::Springs)
+        {
+            ball.checkSpringCollision(spring);
+        }
+    }
+
+    // balls of body vs springs
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        for (graphs::Ball &cornerBall : body.cornerBalls)
+        {
+            for (graphs::Spring &freeSpring : graphs::Springs)
+            {
+                cornerBall.checkSpringCollision(freeSpring);
+            }
+        }
+    }
+
+    // body vs body
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        for (int j = i + 1; j < graphs::SoftBodys.size(); j++)
+        {
+            checkBodyCollision(graphs::SoftBodys[i], graphs::SoftBodys[j]);
+        }
+    }
+}
+
+// ropes, their segments are checked like free springs
+static void resolveRopeCollisions()
+{
+    for (int i = 0; i < graphs::Ropes.size(); i++)
+    {
+        graphs::Rope &rope = graphs::Ropes[i];
+
+        // loose balls vs rope
+        for (graphs::Ball &ball : graphs::Balls)
+        {
+            checkRopeCollision(ball, rope);
+        }
+
+        // bodys vs rope, both ways so the rope can not pass between the corners
+        for (graphs::SoftBody &body : graphs::SoftBodys)
+        {
+            if (!rope.bounds.overlaps(bodyBounds(body)))
+            {
+                continue;
+            }
+            for (graphs::Ball &cornerBall : body.cornerBalls)
+            {
+                checkRopeCollision(cornerBall, rope);
+            }
+            for (graphs::Ball &link : rope.links)
+            {
+                for (graphs::Spring &spring : body.edgeSprings)
+                {
+                    link.checkSpringCollision(spring);
+                }
+            }
+        }
+
+        // links vs free springs
+        for (graphs::Spring &spring : graphs::Springs)
+        {
+            if (!rope.bounds.overlaps(linalg::AABB::fromSegment(spring.ball1.pos, spring.ball2.pos)))
+            {
+                continue;
+            }
+            for (graphs::Ball &link : rope.links)
+            {
+                link.checkSpringCollision(spring);
+            }
+        }
+
+        // rope vs rope
+        for (int j = i + 1; j < graphs::Ropes.size(); j++)
+        {
+            graphs::Rope &other = graphs::Ropes[j];
+            if (!rope.bounds.overlaps(other.bounds))
+            {
+                continue;
+            }
+            for (graphs::Ball &link : rope.links)
+            {
+                checkRopeCollision(link, other);
+            }
+            for (graphs::Ball &link : other.links)
+            {
+                for (graphs::Spring &segment : rope.segments)
+                {
+                    link.checkSpringCollision(segment);
+                }
+            }
+        }
+    }
+}
+
+// islands of the multi-rate step, loose balls joined by free springs share one island
+struct RateIslands
+{
+    std::vector<int> parents;     // union find over the loose balls
+    std::vector<int> ballLevels;  // the root of an island keeps its level
+    std::vector<int> roots;       // island of every loose ball
+    std::vector<int> springRoots; // island of every free spring, -1 for a spring whose ball is not in graphs::Balls
+    std::vector<float> stiffness; // summed stiffness of the springs on a ball
+
+    // members of each level, a level L island takes L + 1 sub-steps per step
+    // the balls and the springs of a level are sorted by island, so the members of an island are next to each other
+    std::vector<std::vector<int>> balls, springs, bodys, ropes;
+};
+
+static thread_local RateIslands islands;
+
+static int findIsland(int ball)
+{
+    while (islands.parents[ball] != ball)
+    {
+        islands.parents[ball] = islands.parents[islands.parents[ball]];
+        ball = islands.parents[ball];
+    }
+    return ball;
+}
+
+// the smallest level whose sub-steps are at least steps, the stiffest islands take the sub-steps of the uniform step
+static int rateLevel(float steps)
+{
+    return std::clamp(static_cast<int>(std::ceil(steps)), 1, physics::SUB_STEPS) - 1;
+}
+
+// sub-steps a ball needs for its springs and its speed, the highest frequency is bounded by sqrt(2 * summed stiffness / mass)
+static float requiredSteps(const graphs::Ball &ball, float stiffness)
+{
+    float frequency = std::sqrt(2.f * stiffness * physics::PIXEL_PER_METER / ball.mass);
+    float stiffnessSteps = frequency * physics::FIXED_DELTA_TIME / physics::STIFFNESS_STEP;
+    float motionSteps = ball.vel.magnitude() * physics::FIXED_DELTA_TIME / (ball.radius * physics::CCD_MOTION_THRESHOLD);
+    return std::max(stiffnessSteps, motionSteps);
+}
+
+// contacts inside the loose islands of a level, the contacts between islands wait for the end of the step
+static void resolveIslandContacts(int level)
+{
+    const std::vector<int> &balls = islands.balls[level];
+    const std::vector<int> &springs = islands.springs[level];
+    int firstSpring = 0;
+    for (int first = 0, last = 0; first < balls.size(); first = last)
+    {
+        int root = islands.roots[balls[first]];
+        while (last < balls.size() && islands.roots[balls[last]] == root)
+        {
+            last++;
+        }
+        while (firstSpring < springs.size() && islands.springRoots[springs[firstSpring]] < root)
+        {
+            firstSpring++;
+        }
+        int lastSpring = firstSpring;
+        while (lastSpring < springs.size() && islands.springRoots[springs[lastSpring]] == root)
+        {
+            lastSpring++;
+        }
+
+        for (int i = first; i < last; i++)
+        {
+            graphs::Ball &ball = graphs::Balls[balls[i]];
+            for (int j = i + 1; j < last; j++)
+            {
+                ball.checkBallCollision(graphs::Balls[balls[j]]);
+            }
+            for (int j = firstSpring; j < lastSpring; j++)
+            {
+                ball.checkSpringCollision(graphs::Springs[springs[j]]);
+            }
+        }
+        firstSpring = lastSpring;
+    }
+}
+
+// puts every island into the level of its stiffest or fastest ball
+static int assignLevels()
+{
+    int levelCount = physics::SUB_STEPS;
+    islands.balls.resize(levelCount);
+    islands.springs.resize(levelCount);
+    islands.bodys.resize(levelCount);
+    islands.ropes.resize(levelCount);
+    for (int level = 0; level < levelCount; level++)
+    {
+        islands.balls[level].clear();
+        islands.springs[level].clear();
+        islands.bodys[level].clear();
+        islands.ropes[level].clear();
+    }
+
+    // loose balls, springs hold references into graphs::Balls
+    int ballCount = graphs::Balls.size();
+    islands.parents.resize(ballCount);
+    islands.stiffness.assign(ballCount, 0.f);
+    islands.ballLevels.assign(ballCount, 0);
+    for (int i = 0; i < ballCount; i++)
+    {
+        islands.parents[i] = i;
+    }
+    for (graphs::Spring &spring : graphs::Springs)
+    {
+        int ball1 = &spring.ball1 - graphs::Balls.data();
+        int ball2 = &spring.ball2 - graphs::Balls.data();
+        if (ball1 < 0 || ball1 >= ballCount || ball2 < 0 || ball2 >= ballCount)
+        {
+            continue;
+        }
+        islands.stiffness[ball1] += spring.springCoefficient;
+        islands.stiffness[ball2] += spring.springCoefficient;
+        islands.parents[findIsland(ball1)] = findIsland(ball2);
+    }
+
+    int maxLevel = 0;
+    islands.roots.resize(ballCount);
+    for (int i = 0; i < ballCount; i++)
+    {
+        int root = findIsland(i);
+        int level = rateLevel(requiredSteps(graphs::Balls[i], islands.stiffness[i]));
+        islands.roots[i] = root;
+        islands.ballLevels[root] = std::max(islands.ballLevels[root], level);
+    }
+    for (int i = 0; i < ballCount; i++)
+    {
+        int level = islands.ballLevels[islands.roots[i]];
+        islands.balls[level].push_back(i);
+        maxLevel = std::max(maxLevel, level);
+    }
+    islands.springRoots.resize(graphs::Springs.size());
+    for (int i = 0; i < graphs::Springs.size(); i++)
+    {
+        // a spring whose ball is not in graphs::Balls has no island, it is pulled at the rate of the whole step
+        int ball1 = &graphs::Springs[i].ball1 - graphs::Balls.data();
+        islands.springRoots[i] = (ball1 >= 0 && ball1 < ballCount) ? islands.roots[ball1] : -1;
+        int level = (islands.springRoots[i] >= 0) ? islands.ballLevels[islands.springRoots[i]] : 0;
+        islands.springs[level].push_back(i);
+    }
+    for (int level = 0; level < levelCount; level++)
+    {
+        std::stable_sort(islands.balls[level].begin(), islands.balls[level].end(), [](int a, int b)
+                         { return islands.roots[a] < islands.roots[b]; });
+        std::stable_sort(islands.springs[level].begin(), islands.springs[level].end(), [](int a, int b)
+                         { return islands.springRoots[a] < islands.springRoots[b]; });
+    }
+
+    // soft bodys, every corner is pulled by the springs to all the other corners
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        graphs::SoftBody &body = graphs::SoftBodys[i];
+        int cornerCount = body.cornerBalls.size();
+        islands.stiffness.assign(cornerCount, 0.f);
+        for (graphs::Spring &spring : body.edgeSprings)
+        {
+            int ball1 = &spring.ball1 - body.cornerBalls.data();
+            int ball2 = &spring.ball2 - body.cornerBalls.data();
+            if (ball1 < 0 || ball1 >= cornerCount || ball2 < 0 || ball2 >= cornerCount)
+            {
+                continue;
+            }
+            islands.stiffness[ball1] += spring.springCoefficient;
+            islands.stiffness[ball2] += spring.springCoefficient;
+        }
+
+        // the pressure pushes a corner out with the area the whole ring sweeps, like a spring of pressureStiffness * perimeter * edge length
+        float perimeter = 0.f;
+        for (int j = 0; j < cornerCount; j++)
+        {
+            perimeter += (body.cornerBalls[(j + 1) % cornerCount].pos - body.cornerBalls[j].pos).magnitude();
+        }
+        float pressureStiffness = (cornerCount > 0) ? body.pressureStiffness * perimeter * perimeter / cornerCount / 2.f : 0.f;
+
+        int level = 0;
+        for (int j = 0; j < cornerCount; j++)
+        {
+            level = std::max(level, rateLevel(requiredSteps(body.cornerBalls[j], islands.stiffness[j] + pressureStiffness)));
+        }
+        islands.bodys[level].push_back(i);
+        maxLevel = std::max(maxLevel, level);
+    }
+
+    // ropes keep their lengths at any step, they only follow the motion of their links
+    for (int i = 0; i < graphs::Ropes.size(); i++)
+    {
+        int level = 0;
+        for (const graphs::Ball &link : graphs::Ropes[i].links)
+        {
+            level = std::max(level, rateLevel(requiredSteps(link, 0.f)));
+        }
+        islands.ropes[level].push_back(i);
+        maxLevel = std::max(maxLevel, level);
+    }
+    return maxLevel;
+}
+
+void physics::step()
+{
+    for (int step = 0; step < physics::SUB_STEPS; step++)
+    {
+        physics::subStep(physics::SUB_DELTA_TIME);
+    }
+}
+
+void physics::subStep(float deltaTime)
+{
+    physics::metrics.subSteps++;
+    physics::collisionGrid.isStale = true;
+    resetStepTimes();
+
+    // resets forces
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        resetForces(body.cornerBalls);
+    }
+    resetForces(graphs::Balls);
+
+    // computes forces
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        computeBodyForces(body);
+    }
+    for (graphs::Spring &spring : graphs::Springs)
+    {
+        spring.computeSpringForce();
+    }
+
+    // physics
+    // update soft body
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        integrateBody(body, deltaTime);
+    }
+
+    // update balls
+    for (graphs::Ball &ball : graphs::Balls)
+    {
+        integrateBall(ball, deltaTime);
+    }
+
+    // update ropes
+    updateRopes(deltaTime);
+
+    // controls of collisions
+    resolveInteractions();
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        resolveSelfCollisions(body);
+    }
+    resolveRopeCollisions();
+}
+
+void physics::multiRateStep()
+{
+    // the fine clock ticks at the rate of the highest level in use, never faster than the uniform step
+    int maxLevel = assignLevels();
+    int tickCount = maxLevel + 1;
+    float tickTime = physics::FIXED_DELTA_TIME / tickCount;
+
+    for (int tick = 0; tick < tickCount; tick++)
+    {
+        physics::metrics.subSteps++;
+        physics::collisionGrid.isStale = true;
+        resetStepTimes();
+
+        for (int level = 0; level <= maxLevel; level++)
+        {
+            // sub-step index of a level starts at tick index * tickCount / steps and lasts until the next one
+            int steps = level + 1;
+            int index = (tick * steps + tickCount - 1) / tickCount;
+            if (index * tickCount / steps != tick)
+            {
+                continue;
+            }
+            float deltaTime = ((index + 1) * tickCount / steps - tick) * tickTime;
+
+            // loose balls and the free springs between them
+            for (int ball : islands.balls[level])
+            {
+                graphs::Balls[ball].springForce = linalg::Vector(0.f, 0.f);
+                graphs::Balls[ball].pressureForce = linalg::Vector(0.f, 0.f);
+            }
+            for (int spring : islands.springs[level])
+            {
+                graphs::Springs[spring].computeSpringForce();
+            }
+            for (int ball : islands.balls[level])
+            {
+                integrateBall(graphs::Balls[ball], deltaTime);
+            }
+            resolveIslandContacts(level);
+
+            // soft bodys, a body keeps its shape at its own rate
+            for (int body : islands.bodys[level])
+            {
+                resetForces(graphs::SoftBodys[body].cornerBalls);
+                computeBodyForces(graphs::SoftBodys[body]);
+                integrateBody(graphs::SoftBodys[body], deltaTime);
+                resolveSelfCollisions(graphs::SoftBodys[body]);
+            }
+
+            // ropes
+            for (int rope : islands.ropes[level])
+            {
+                resetForces(graphs::Ropes[rope].links);
+                graphs::Ropes[rope].update(deltaTime);
+            }
+        }
+    }
+
+    // the islands meet once at the end of the step, where all levels have finished their sub-steps
+    // the fast movers are swept against the other islands at every sub-step, so they can not pass through them before
+    resolveInteractions();
+    resolveRopeCollisions();
+}
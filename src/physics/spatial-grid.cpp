@@ -0,0 +1,430 @@
+#include "../../include/physics/spatial-grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+thread_local physics::SpatialGrid physics::collisionGrid;
+
+physics::SpatialGrid::SpatialGrid(float cellSize, int tableSize)
+    : cellSize(cellSize),
+      tableSize(tableSize),
+      particleCount(0),
+      maxSpeed(0.f),
+      isStale(true),
+      stamp(0)
+{
+}
+
+bool physics::SpatialGrid::isBall(ItemKind kind)
+{
+    return kind == ItemKind::Ball || kind == ItemKind::CornerBall || kind == ItemKind::RopeLink;
+}
+
+bool physics::SpatialGrid::isSpring(ItemKind kind)
+{
+    return kind == ItemKind::Spring || kind == ItemKind::BodySpring || kind == ItemKind::RopeSegment;
+}
+
+graphs::Ball &physics::SpatialGrid::getBall(const SpatialItem &item)
+{
+    if (item.kind == ItemKind::CornerBall)
+    {
+        return graphs::SoftBodys[item.body].cornerBalls[item.index];
+    }
+    if (item.kind == ItemKind::RopeLink)
+    {
+        return graphs::Ropes[item.body].links[item.index];
+    }
+    return graphs::Balls[item.index];
+}
+
+graphs::Spring &physics::SpatialGrid::getSpring(const SpatialItem &item)
+{
+    if (item.kind == ItemKind::BodySpring)
+    {
+        return graphs::SoftBodys[item.body].edgeSprings[item.index];
+    }
+    if (item.kind == ItemKind::RopeSegment)
+    {
+        return graphs::Ropes[item.body].segments[item.index];
+    }
+    return graphs::Springs[item.index];
+}
+
+graphs::SoftBody &physics::SpatialGrid::getSoftBody(const SpatialItem &item)
+{
+    return graphs::SoftBodys[item.body];
+}
+
+int physics::SpatialGrid::cellIndex(long long x, long long y) const
+{
+    unsigned hash = (static_cast<unsigned>(x) * 73856093u) ^ (static_cast<unsigned>(y) * 19349663u);
+    return hash % this->tableSize;
+}
+
+template <typename Visit>
+void physics::SpatialGrid::forEachBucket(const linalg::AABB &box, Visit visit) const
+{
+    // the span is counted in floating point, boxes that are huge, far away or not finite can not overflow the cell indices
+    const double FAR = 1e15;
+    double minX = std::floor(box.min.x / this->cellSize), maxX = std::floor(box.max.x / this->cellSize);
+    double minY = std::floor(box.min.y / this->cellSize), maxY = std::floor(box.max.y / this->cellSize);
+    bool isNear = std::abs(minX) < FAR && std::abs(maxX) < FAR && std::abs(minY) < FAR && std::abs(maxY) < FAR;
+    if (!isNear || !((maxX - minX + 1.0) * (maxY - minY + 1.0) < this->tableSize))
+    {
+        for (int bucket = 0; bucket < this->tableSize; bucket++)
+        {
+            visit(bucket);
+        }
+        return;
+    }
+
+    for (long long x = minX; x <= maxX; x++)
+    {
+        for (long long y = minY; y <= maxY; y++)
+        {
+            visit(this->cellIndex(x, y));
+        }
+    }
+}
+
+void physics::SpatialGrid::addItem(ItemKind kind, int body, int index, const linalg::AABB &box)
+{
+    if (isBall(kind))
+    {
+        this->particleCount++;
+        this->maxSpeed = std::max(this->maxSpeed, getBall({kind, body, index, box}).vel.magnitude());
+    }
+    this->bounds = this->items.empty() ? box : this->bounds.merge(box);
+    this->items.push_back({kind, body, index, box});
+}
+
+void physics::SpatialGrid::build()
+{
+    this->items.clear();
+    this->bounds = linalg::AABB();
+    this->particleCount = 0;
+    this->maxSpeed = 0.f;
+    this->isStale = false;
+
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        const graphs::Ball &ball = graphs::Balls[i];
+        this->addItem(ItemKind::Ball, -1, i, linalg::AABB::fromCircle(ball.pos, ball.radius));
+    }
+    for (int i = 0; i < graphs::Springs.size(); i++)
+    {
+        const graphs::Spring &spring = graphs::Springs[i];
+        this->addItem(ItemKind::Spring, -1, i, linalg::AABB::fromSegment(spring.ball1.pos, spring.ball2.pos));
+    }
+    for (int i = 0; i < graphs::SoftBodys.size(); i++)
+    {
+        const graphs::SoftBody &body = graphs::SoftBodys[i];
+        linalg::AABB bodyBox = linalg::AABB::fromCircle(body.center, body.radius);
+
+        for (int j = 0; j < body.cornerBalls.size(); j++)
+        {
+            const graphs::Ball &ball = body.cornerBalls[j];
+            linalg::AABB ballBox = linalg::AABB::fromCircle(ball.pos, ball.radius);
+            this->addItem(ItemKind::CornerBall, i, j, ballBox);
+            bodyBox = bodyBox.merge(ballBox);
+        }
+        for (int j = 0; j < body.edgeSprings.size(); j++)
+        {
+            const graphs::Spring &spring = body.edgeSprings[j];
+            this->addItem(ItemKind::BodySpring, i, j, linalg::AABB::fromSegment(spring.ball1.pos, spring.ball2.pos));
+        }
+        this->addItem(ItemKind::SoftBody, i, -1, bodyBox);
+    }
+    for (int i = 0; i < graphs::Ropes.size(); i++)
+    {
+        const graphs::Rope &rope = graphs::Ropes[i];
+        for (int j = 0; j < rope.links.size(); j++)
+        {
+            const graphs::Ball &link = rope.links[j];
+            this->addItem(ItemKind::RopeLink, i, j, linalg::AABB::fromCircle(link.pos, link.radius));
+        }
+        for (int j = 0; j < rope.segments.size(); j++)
+        {
+            const graphs::Spring &segment = rope.segments[j];
+            this->addItem(ItemKind::RopeSegment, i, j, linalg::AABB::fromSegment(segment.ball1.pos, segment.ball2.pos));
+        }
+    }
+
+    // counts the items of every cell, then places them after the prefix sum
+    this->cellStart.assign(this->tableSize + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < this->items.size(); i++)
+        {
+            this->forEachBucket(this->items[i].box, [this, pass, i](int cell)
+                                {
+                                    if (pass == 0)
+                                    {
+                                        this->cellStart[cell + 1]++;
+                                    }
+                                    else
+                                    {
+                                        this->cellItems[--this->cellStart[cell + 1]] = i;
+                                    }
+                                });
+        }
+
+        if (pass == 0)
+        {
+            for (int cell = 0; cell < this->tableSize; cell++)
+            {
+                this->cellStart[cell + 1] += this->cellStart[cell];
+            }
+            this->cellItems.resize(this->cellStart[this->tableSize]);
+        }
+    }
+
+    // the second pass moved the end of every cell back to its start, one slot late
+    for (int cell = 0; cell < this->tableSize; cell++)
+    {
+        this->cellStart[cell] = this->cellStart[cell + 1];
+    }
+    this->cellStart[this->tableSize] = this->cellItems.size();
+
+    this->stamps.assign(this->items.size(), 0);
+    this->stamp = 0;
+}
+
+bool physics::SpatialGrid::nextStamp(int item)
+{
+    if (this->stamps[item] == this->stamp)
+    {
+        return false;
+    }
+    this->stamps[item] = this->stamp;
+    return true;
+}
+
+float physics::SpatialGrid::distanceTo(const SpatialItem &item, const linalg::Vector &point) const
+{
+    switch (item.kind)
+    {
+    case ItemKind::Ball:
+    case ItemKind::CornerBall:
+    case ItemKind::RopeLink:
+    {
+        const graphs::Ball &ball = getBall(item);
+        return std::max(0.f, (point - ball.pos).magnitude() - ball.radius);
+    }
+    case ItemKind::Spring:
+    case ItemKind::BodySpring:
+    case ItemKind::RopeSegment:
+    {
+        const graphs::Spring &spring = getSpring(item);
+        linalg::Vector springVector = spring.ball2.pos - spring.ball1.pos;
+        float lengthSquared = springVector.dot(springVector);
+        float projection = (lengthSquared > 0.f) ? std::clamp((point - spring.ball1.pos).dot(springVector) / lengthSquared, 0.f, 1.f) : 0.f;
+        return (point - (spring.ball1.pos + springVector * projection)).magnitude();
+    }
+    default:
+    {
+        const graphs::SoftBody &body = getSoftBody(item);
+        return std::max(0.f, (point - body.center).magnitude() - body.radius);
+    }
+    }
+}
+
+void physics::SpatialGrid::queryPoint(const linalg::Vector &point, float tolerance, std::vector<SpatialItem> &result)
+{
+    result.clear();
+    linalg::AABB box = linalg::AABB::fromCircle(point, tolerance);
+    if (this->items.empty() || !box.overlaps(this->bounds))
+    {
+        return;
+    }
+
+    // strictly inside for balls and bodies when there is no tolerance, like the mouse picking
+    // the cells are walked like queryBox, a tolerance larger than the table visits every bucket once
+    this->stamp++;
+    this->forEachBucket(box.intersect(this->bounds), [this, &point, tolerance, &result](int cell)
+                        {
+                            for (int i = this->cellStart[cell]; i < this->cellStart[cell + 1]; i++)
+                            {
+                                int item = this->cellItems[i];
+                                if (!this->nextStamp(item) || !this->items[item].box.expand(tolerance).contains(point))
+                                {
+                                    continue;
+                                }
+
+                                const SpatialItem &candidate = this->items[item];
+                                bool isInside;
+                                if (candidate.kind == ItemKind::Ball || candidate.kind == ItemKind::CornerBall || candidate.kind == ItemKind::RopeLink)
+                                {
+                                    const graphs::Ball &ball = getBall(candidate);
+                                    isInside = (ball.pos - point).magnitude() < ball.radius + tolerance;
+                                }
+                                else if (candidate.kind == ItemKind::SoftBody)
+                                {
+                                    const graphs::SoftBody &body = getSoftBody(candidate);
+                                    isInside = (body.center - point).magnitude() < body.radius + tolerance;
+                                }
+                                else
+                                {
+                                    isInside = this->distanceTo(candidate, point) <= tolerance;
+                                }
+
+                                if (isInside)
+                                {
+                                    result.push_back(candidate);
+                                }
+                            }
+                        });
+}
+
+void physics::SpatialGrid::queryBox(const linalg::AABB &box, std::vector<SpatialItem> &result)
+{
+    result.clear();
+    if (this->items.empty() || !box.overlaps(this->bounds))
+    {
+        return;
+    }
+
+    // only the occupied part of the box is searched, a part larger than the table visits every bucket once
+    this->stamp++;
+    this->forEachBucket(box.intersect(this->bounds), [this, &box, &result](int cell)
+                        {
+                            for (int i = this->cellStart[cell]; i < this->cellStart[cell + 1]; i++)
+                            {
+                                int item = this->cellItems[i];
+                                if (this->nextStamp(item) && this->items[item].box.overlaps(box))
+                                {
+                                    result.push_back(this->items[item]);
+                                }
+                            }
+                        });
+}
+
+bool physics::SpatialGrid::raycast(const linalg::Vector &origin, const linalg::Vector &direction, float maxDistance, RayHit &hit)
+{
+    linalg::Vector unit = direction.unit();
+    if (this->items.empty() || (unit.x == 0.f && unit.y == 0.f))
+    {
+        return false;
+    }
+
+    // the ray ends where it leaves the box of all items
+    this->stamp++;
+    hit.distance = std::min(maxDistance, (origin - this->bounds.center()).magnitude() + this->bounds.size().magnitude());
+    bool isHit = false;
+
+    // walks the cells along the ray, nearest first
+    int cellX = std::floor(origin.x / this->cellSize);
+    int cellY = std::floor(origin.y / this->cellSize);
+    int stepX = (unit.x > 0.f) ? 1 : -1;
+    int stepY = (unit.y > 0.f) ? 1 : -1;
+    float deltaX = (unit.x != 0.f) ? std::abs(this->cellSize / unit.x) : 1e30f;
+    float deltaY = (unit.y != 0.f) ? std::abs(this->cellSize / unit.y) : 1e30f;
+    float nextX = (unit.x != 0.f) ? ((cellX + (stepX > 0 ? 1 : 0)) * this->cellSize - origin.x) / unit.x : 1e30f;
+    float nextY = (unit.y != 0.f) ? ((cellY + (stepY > 0 ? 1 : 0)) * this->cellSize - origin.y) / unit.y : 1e30f;
+    float cellDistance = 0.f;
+
+    while (cellDistance <= hit.distance)
+    {
+        int cell = this->cellIndex(cellX, cellY);
+        for (int i = this->cellStart[cell]; i < this->cellStart[cell + 1]; i++)
+        {
+            int item = this->cellItems[i];
+            const SpatialItem &candidate = this->items[item];
+            if (candidate.kind == ItemKind::SoftBody || !this->nextStamp(item))
+            {
+                continue;
+            }
+
+            float distance = -1.f;
+            if (candidate.kind == ItemKind::Ball || candidate.kind == ItemKind::CornerBall || candidate.kind == ItemKind::RopeLink)
+            {
+                // ray vs circle
+                const graphs::Ball &ball = getBall(candidate);
+                linalg::Vector offset = origin - ball.pos;
+                float b = offset.dot(unit);
+                float c = offset.dot(offset) - ball.radius * ball.radius;
+                float discriminant = b * b - c;
+                if (discriminant >= 0.f)
+                {
+                    distance = (c <= 0.f) ? 0.f : -b - std::sqrt(discriminant);
+                }
+            }
+            else
+            {
+                // ray vs segment
+                const graphs::Spring &spring = getSpring(candidate);
+                linalg::Vector springVector = spring.ball2.pos - spring.ball1.pos;
+                float denominator = unit.x * springVector.y - unit.y * springVector.x;
+                if (denominator != 0.f)
+                {
+                    linalg::Vector offset = spring.ball1.pos - origin;
+                    float rayDistance = (offset.x * springVector.y - offset.y * springVector.x) / denominator;
+                    float springFraction = (offset.x * unit.y - offset.y * unit.x) / denominator;
+                    if (springFraction >= 0.f && springFraction <= 1.f)
+                    {
+                        distance = rayDistance;
+                    }
+                }
+            }
+
+            if (distance >= 0.f && distance <= hit.distance)
+            {
+                hit.item = candidate;
+                hit.distance = distance;
+                hit.point = origin + unit * distance;
+                isHit = true;
+            }
+        }
+
+        // hits found so far are closer than the rest of the cells
+        if (nextX < nextY)
+        {
+            cellDistance = nextX;
+            nextX += deltaX;
+            cellX += stepX;
+        }
+        else
+        {
+            cellDistance = nextY;
+            nextY += deltaY;
+            cellY += stepY;
+        }
+    }
+
+    return isHit;
+}
+
+void physics::SpatialGrid::nearestParticles(const linalg::Vector &point, int count, std::vector<SpatialItem> &result)
+{
+    result.clear();
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // grows the searched box until it holds enough particles closer than its half size
+    float searchRadius = this->cellSize;
+    while (true)
+    {
+        linalg::AABB box(point - linalg::Vector(searchRadius, searchRadius), point + linalg::Vector(searchRadius, searchRadius));
+        this->queryBox(box, result);
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [](const SpatialItem &item)
+                                    { return !isBall(item.kind); }),
+                     result.end());
+
+        int found = std::min<int>(count, result.size());
+        std::partial_sort(result.begin(), result.begin() + found, result.end(),
+                          [this, &point](const SpatialItem &a, const SpatialItem &b)
+                          { return this->distanceTo(a, point) < this->distanceTo(b, point); });
+
+        bool isComplete = found == count && this->distanceTo(result[found - 1], point) <= searchRadius;
+        bool coversAll = result.size() == this->particleCount;
+        if (isComplete || coversAll)
+        {
+            result.resize(found);
+            return;
+        }
+        searchRadius *= 2.f;
+    }
+}
@@ -0,0 +1,133 @@
+#include "../../include/render/camera.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include <algorithm>
+
+// limits of the zoom in world units per pixel
+static const float MIN_ZOOM = 0.05f;
+static const float MAX_ZOOM = 50.f;
+
+render::Camera::Camera(sf::Vector2f screenSize, linalg::Vector center)
+    : view(sf::Vector2f(center.x, center.y), screenSize),
+      screenSize(screenSize),
+      zoom(1.f),
+      followedBody(-1)
+{
+}
+
+void render::Camera::pan(const linalg::Vector &offset)
+{
+    this->view.move({offset.x, offset.y});
+}
+
+void render::Camera::zoomAt(float factor, const linalg::Vector &point)
+{
+    float zoom = std::clamp(this->zoom * factor, MIN_ZOOM, MAX_ZOOM);
+    factor = zoom / this->zoom;
+    this->zoom = zoom;
+
+    // the point keeps its place on the screen
+    sf::Vector2f center = this->view.getCenter();
+    this->view.setCenter({point.x + (center.x - point.x) * factor, point.y + (center.y - point.y) * factor});
+    this->view.setSize({this->screenSize.x * this->zoom, this->screenSize.y * this->zoom});
+}
+
+void render::Camera::follow(int body)
+{
+    this->followedBody = body;
+}
+
+void render::Camera::update()
+{
+    if (this->followedBody >= 0 && this->followedBody < graphs::SoftBodys.size())
+    {
+        const linalg::Vector &center = graphs::SoftBodys[this->followedBody].center;
+        this->view.setCenter({center.x, center.y});
+    }
+}
+
+void render::Camera::reset(const linalg::AABB &area)
+{
+    linalg::Vector size = area.size();
+    this->zoom = std::clamp(std::max(size.x / this->screenSize.x, size.y / this->screenSize.y), MIN_ZOOM, MAX_ZOOM);
+    this->followedBody = -1;
+
+    linalg::Vector center = area.center();
+    this->view.setCenter({center.x, center.y});
+    this->view.setSize({this->screenSize.x * this->zoom, this->screenSize.y * this->zoom});
+}
+
+linalg::AABB render::Camera::visibleArea() const
+{
+    sf::Vector2f center = this->view.getCenter();
+    sf::Vector2f size = this->view.getSize();
+    return linalg::AABB(linalg::Vector(center.x - size.x / 2, center.y - size.y / 2), linalg::Vector(center.x + size.x / 2, center.y + size.y / 2));
+}
+
+render::CulledRenderer::CulledRenderer(float pointRadius, float coarseRadius)
+    : pointRadius(pointRadius),
+      coarseRadius(coarseRadius),
+      drawnObjects(0),
+      points(sf::PrimitiveType::Triangles),
+      coarseCircle(1.f, 12)
+{
+}
+
+void render::CulledRenderer::drawBall(sf::RenderTarget &target, graphs::Ball &ball, float zoom)
+{
+    float screenRadius = ball.radius / zoom;
+
+    if (screenRadius < this->pointRadius)
+    {
+        // one pixel sized quad added to the batch
+        float half = std::max(ball.radius, zoom * 0.5f);
+        sf::Vector2f corners[4] = {{ball.pos.x - half, ball.pos.y - half}, {ball.pos.x + half, ball.pos.y - half}, {ball.pos.x + half, ball.pos.y + half}, {ball.pos.x - half, ball.pos.y + half}};
+        int indices[6] = {0, 1, 2, 0, 2, 3};
+        for (int index : indices)
+        {
+            this->points.append(sf::Vertex{corners[index], ball.color});
+        }
+    }
+    else if (screenRadius < this->coarseRadius)
+    {
+        this->coarseCircle.setRadius(ball.radius);
+        this->coarseCircle.setOrigin({ball.radius, ball.radius});
+        this->coarseCircle.setPosition({ball.pos.x, ball.pos.y});
+        this->coarseCircle.setFillColor(ball.color);
+        target.draw(this->coarseCircle);
+    }
+    else
+    {
+        ball.draw(target);
+    }
+}
+
+void render::CulledRenderer::draw(sf::RenderTarget &target, physics::SpatialGrid &grid, const Camera &camera)
+{
+    grid.queryBox(camera.visibleArea(), this->visibleItems);
+    this->points.clear();
+    this->drawnObjects = 0;
+
+    for (const physics::SpatialItem &item : this->visibleItems)
+    {
+        switch (item.kind)
+        {
+        case physics::ItemKind::Ball:
+        case physics::ItemKind::CornerBall:
+        case physics::ItemKind::RopeLink:
+            this->drawBall(target, physics::SpatialGrid::getBall(item), camera.zoom);
+            this->drawnObjects++;
+            break;
+        case physics::ItemKind::Spring:
+        case physics::ItemKind::BodySpring:
+        case physics::ItemKind::RopeSegment:
+            physics::SpatialGrid::getSpring(item).draw(target);
+            this->drawnObjects++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    target.draw(this->points);
+}
@@ -0,0 +1,156 @@
+#include "../../include/render/frame-recorder.hpp"
+#include "../../include/render/render.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+render::FrameRecorder::FrameRecorder(const std::string &directory, sf::Vector2u size, ImageFormat format, int workerCount)
+    : directory(directory),
+      format(format),
+      size(size),
+      workerCount(workerCount),
+      frameCount(0),
+      maxQueued(0),
+      hasFailed(false),
+      readBackMilliseconds(0.0),
+      renderedFrames(0),
+      isFinished(false)
+{
+    // PNG compression is the slow part, so by default it gets every core but the one that simulates and renders
+    if (this->workerCount <= 0)
+    {
+        int cores = std::thread::hardware_concurrency();
+        this->workerCount = std::max(1, cores - 1);
+    }
+    this->maxQueued = 2 * this->workerCount;
+}
+
+render::FrameRecorder::~FrameRecorder()
+{
+    this->finish();
+}
+
+bool render::FrameRecorder::start()
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+
+    for (sf::RenderTexture &texture : this->textures)
+    {
+        if (!texture.resize(this->size))
+        {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < this->workerCount; i++)
+    {
+        this->workers.emplace_back(&FrameRecorder::encode, this);
+    }
+    return true;
+}
+
+void render::FrameRecorder::record(const sf::View &view)
+{
+    sf::RenderTexture &texture = this->textures[this->renderedFrames % 2];
+    texture.setView(view);
+    texture.clear(sf::Color::Black);
+    render::drawWorld(texture);
+    texture.display();
+
+    // the previous frame is usually finished on the GPU by now, reading it still stalls this thread for the copy
+    if (this->renderedFrames > 0)
+    {
+        this->readBack(this->renderedFrames - 1);
+    }
+    this->renderedFrames++;
+}
+
+void render::FrameRecorder::readBack(int frame)
+{
+    // copyToImage waits for the GPU and copies the pixels on this thread, its cost is measured for every frame
+    auto start = std::chrono::steady_clock::now();
+    sf::Image image = this->textures[frame % 2].getTexture().copyToImage();
+    this->readBackMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::unique_lock<std::mutex> lock(this->queueMutex);
+    this->queueChanged.wait(lock, [this]()
+                            { return this->queue.size() < this->maxQueued; });
+    this->queue.emplace_back(frame, std::move(image));
+    this->frameCount++;
+    this->queueChanged.notify_all();
+}
+
+void render::FrameRecorder::finish()
+{
+    if (this->isFinished)
+    {
+        return;
+    }
+
+    if (this->renderedFrames > 0 && !this->workers.empty())
+    {
+        this->readBack(this->renderedFrames - 1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->isFinished = true;
+    }
+    this->queueChanged.notify_all();
+
+    for (std::thread &worker : this->workers)
+    {
+        worker.join();
+    }
+    this->workers.clear();
+}
+
+void render::FrameRecorder::encode()
+{
+    while (true)
+    {
+        std::pair<int, sf::Image> item;
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            this->queueChanged.wait(lock, [this]()
+                                    { return !this->queue.empty() || this->isFinished; });
+            if (this->queue.empty())
+            {
+                return;
+            }
+            item = std::move(this->queue.front());
+            this->queue.pop_front();
+            this->queueChanged.notify_all();
+        }
+
+        if (!this->save(item.first, item.second))
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            this->hasFailed = true;
+        }
+    }
+}
+
+bool render::FrameRecorder::save(int frame, const sf::Image &image) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame-%06d.%s", frame, (this->format == ImageFormat::Png) ? "png" : "rgba");
+    std::filesystem::path path = std::filesystem::path(this->directory) / name;
+
+    if (this->format == ImageFormat::Png)
+    {
+        return image.saveToFile(path);
+    }
+
+    std::FILE *file = std::fopen(path.string().c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    sf::Vector2u imageSize = image.getSize();
+    size_t byteCount = static_cast<size_t>(imageSize.x) * imageSize.y * 4;
+    bool isWritten = std::fwrite(image.getPixelsPtr(), 1, byteCount, file) == byteCount;
+    return std::fclose(file) == 0 && isWritten;
+}
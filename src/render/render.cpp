@@ -0,0 +1,34 @@
+#include "../../include/render/render.hpp"
+#include "../../include/graphs/spring.hpp"
+#include "../../include/graphs/soft-body.hpp"
+#include "../../include/graphs/static-world.hpp"
+#include "../../include/graphs/rope.hpp"
+
+void render::drawWorld(sf::RenderTarget &target)
+{
+    graphs::World.draw(target);
+    for (graphs::Ball &ball : graphs::Balls)
+    {
+        ball.draw(target);
+    }
+    for (graphs::Spring &spring : graphs::Springs)
+    {
+        spring.draw(target);
+    }
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        // body.draw(target);
+        for (graphs::Ball &ball : body.cornerBalls)
+        {
+            ball.draw(target);
+        }
+        for (graphs::Spring &spring : body.edgeSprings)
+        {
+            spring.draw(target);
+        }
+    }
+    for (graphs::Rope &rope : graphs::Ropes)
+    {
+        rope.draw(target);
+    }
+}
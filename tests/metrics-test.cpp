@@ -0,0 +1,85 @@
+// checks that the energies of the threaded reduction match a sum on the calling thread, exits with 1 when they differ
+//
+// g++ -O2 -std=c++17 tests/metrics-test.cpp src/graphs/*.cpp src/physics/*.cpp -o build/metrics-test -pthread <SFML flags>
+// build/metrics-test
+#include "../include/physics/metrics.hpp"
+#include "../include/physics/physics.hpp"
+#include "../include/graphs/scene.hpp"
+#include "../include/graphs/spring.hpp"
+#include "../include/graphs/soft-body.hpp"
+#include "../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// the sums of the threads are added in another order, so they are compared with a relative tolerance
+static bool isClose(float value, double expected)
+{
+    return std::abs(value - expected) <= 1e-3 * std::max(1.0, std::abs(expected));
+}
+
+int main()
+{
+    // enough objects for several reduction chunks, the gravity differs from the default so a thread reading its own copy is seen
+    physics::g = 4.f;
+    graphs::Scene::random(3, 30000, 40).load();
+    for (int i = 0; i < graphs::Balls.size(); i++)
+    {
+        graphs::Balls[i].vel = linalg::Vector(static_cast<float>(i % 97), -static_cast<float>(i % 31));
+    }
+    for (graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        body.cornerBalls[0].pos = body.cornerBalls[0].pos + linalg::Vector(body.radius * 0.2f, 0.f);
+    }
+    for (int i = 0; i + 1 < graphs::Balls.size(); i += 2)
+    {
+        graphs::Springs.emplace_back(graphs::Balls[i], graphs::Balls[i + 1], 10.f, 0.5f).potentialEnergy = 0.01f * (i % 7);
+    }
+
+    // the reference is summed in double on this thread
+    double floor = graphs::World.bounds.max.y;
+    double kinetic = 0.0, potential = 0.0, spring = 0.0, areaError = 0.0;
+    auto addBall = [&](const graphs::Ball &ball)
+    {
+        double speed = ball.vel.magnitude() / physics::PIXEL_PER_METER;
+        kinetic += 0.5 * ball.mass * speed * speed;
+        potential += ball.mass * physics::g * (floor - ball.pos.y) / physics::PIXEL_PER_METER;
+    };
+    for (const graphs::Ball &ball : graphs::Balls)
+    {
+        addBall(ball);
+    }
+    for (const graphs::Spring &free : graphs::Springs)
+    {
+        spring += free.potentialEnergy;
+    }
+    for (const graphs::SoftBody &body : graphs::SoftBodys)
+    {
+        for (const graphs::Ball &ball : body.cornerBalls)
+        {
+            addBall(ball);
+        }
+        for (const graphs::Spring &edge : body.edgeSprings)
+        {
+            spring += edge.potentialEnergy;
+        }
+        areaError = std::max(areaError, static_cast<double>(std::abs(body.getCurrentArea() - body.restArea) / body.restArea));
+    }
+
+    bool hasFailed = false;
+    for (int threads : {1, 4})
+    {
+        physics::metrics.reductionThreads = threads;
+        physics::metrics.sample();
+
+        bool isEqual = isClose(physics::metrics.kineticEnergy, kinetic) && isClose(physics::metrics.potentialEnergy, potential) &&
+                       isClose(physics::metrics.springEnergy, spring) && isClose(physics::metrics.areaError, areaError);
+        std::cout << threads << " threads: kinetic " << physics::metrics.kineticEnergy << " / " << kinetic
+                  << ", potential " << physics::metrics.potentialEnergy << " / " << potential
+                  << ", spring " << physics::metrics.springEnergy << " / " << spring
+                  << ", area error " << physics::metrics.areaError << " / " << areaError
+                  << (isEqual ? "" : "  FAILED") << std::endl;
+        hasFailed = hasFailed || !isEqual;
+    }
+    return hasFailed ? 1 : 0;
+}
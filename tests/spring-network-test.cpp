@@ -0,0 +1,104 @@
+// checks the springs a network adds: one per edge whatever its direction, none for bad edges, and the faces of an OBJ file, exits with 1 when one differs
+//
+// g++ -O2 -std=c++17 tests/spring-network-test.cpp src/graphs/*.cpp src/physics/*.cpp -o build/spring-network-test -pthread <SFML flags>
+// build/spring-network-test
+#include "../include/graphs/spring-network.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static bool hasFailed = false;
+
+static void check(const std::string &name, bool isPassed)
+{
+    std::cout << name << (isPassed ? ": ok" : ": FAILED") << std::endl;
+    hasFailed = hasFailed || !isPassed;
+}
+
+// the spring between two balls in either direction, nullptr if there is none
+static const graphs::SpringSpec *findSpring(const graphs::Scene &scene, int ball1, int ball2)
+{
+    for (const graphs::SpringSpec &spring : scene.springs)
+    {
+        if ((spring.ball1 == ball1 && spring.ball2 == ball2) || (spring.ball1 == ball2 && spring.ball2 == ball1))
+        {
+            return &spring;
+        }
+    }
+    return nullptr;
+}
+
+static bool hasRestLength(const graphs::Scene &scene, int ball1, int ball2, float length)
+{
+    const graphs::SpringSpec *spring = findSpring(scene, ball1, ball2);
+    return spring != nullptr && std::abs(spring->normalLength - length) < 1e-3f;
+}
+
+int main()
+{
+    graphs::BallSpec ball = {linalg::Vector(0.f, 0.f), sf::Color::White, 5.f, 1.f, 0.5f};
+
+    // three balls of a 30, 40, 50 triangle
+    {
+        graphs::Scene scene;
+        graphs::SpringNetwork network(scene, ball, 0.5f);
+        network.addBall(linalg::Vector(0.f, 0.f));
+        network.addBall(linalg::Vector(30.f, 0.f));
+        network.addBall(linalg::Vector(30.f, 40.f));
+
+        int added = network.addEdges({{0, 1}, {1, 0}, {1, 2}, {2, 1}, {0, 1}});
+        check("reversed duplicate edges add one spring each", added == 2 && scene.springs.size() == 2);
+        check("springs rest at the distance of their balls", hasRestLength(scene, 0, 1, 30.f) && hasRestLength(scene, 1, 2, 40.f));
+
+        check("a self-edge adds no spring", !network.addSpring(2, 2) && scene.springs.size() == 2);
+        bool isOutRejected = !network.addSpring(-1, 0) && !network.addSpring(0, 3) && !network.addSpring(3, 3);
+        check("out-of-range edges add no spring", isOutRejected && network.addEdges({{0, 7}, {-2, 1}, {0, 2}}) == 1 && scene.springs.size() == 3);
+        check("the last edge rests at the hypotenuse", hasRestLength(scene, 0, 2, 50.f));
+    }
+
+    // a scene that already joins two balls
+    {
+        graphs::Scene scene;
+        scene.balls.push_back({linalg::Vector(0.f, 0.f), sf::Color::White, 5.f, 1.f, 0.5f});
+        scene.balls.push_back({linalg::Vector(0.f, 20.f), sf::Color::White, 5.f, 1.f, 0.5f});
+        scene.balls.push_back({linalg::Vector(20.f, 20.f), sf::Color::White, 5.f, 1.f, 0.5f});
+        scene.springs.push_back({0, 1, 15.f, 0.3f});
+
+        graphs::SpringNetwork network(scene, ball, 0.5f);
+        bool isExistingKept = !network.addSpring(1, 0) && !network.addSpring(0, 1) && scene.springs.size() == 1;
+        check("existing scene springs are not added again", isExistingKept && scene.springs[0].normalLength == 15.f);
+        check("new edges of that scene are added", network.addSpring(1, 2) && hasRestLength(scene, 1, 2, 20.f) && scene.springs.size() == 2);
+    }
+
+    // a quad with negative indices is split into a fan, its diagonal is shared by the two triangles
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "spring-network-test.obj";
+        {
+            std::ofstream file(path);
+            file << "v 0 0 0\nv 10 0 0\nv 10 10 0\nv 0 10 0\n"
+                 << "f -4/1 -3/2/2 -2//3 -1\n";
+        }
+
+        graphs::Scene scene;
+        graphs::SpringNetwork network(scene, ball, 0.5f);
+        network.addBall(linalg::Vector(-50.f, -50.f));
+        bool isImported = network.importMesh(path.string(), linalg::Vector(100.f, 100.f), 2.f);
+        check("the OBJ quad is imported", isImported && scene.balls.size() == 5);
+        check("the fan adds the four sides and one diagonal", scene.springs.size() == 5 && findSpring(scene, 2, 4) == nullptr);
+        check("the OBJ springs rest at the scaled distances", hasRestLength(scene, 1, 2, 20.f) && hasRestLength(scene, 2, 3, 20.f) && hasRestLength(scene, 3, 4, 20.f) &&
+                                                               hasRestLength(scene, 4, 1, 20.f) && hasRestLength(scene, 1, 3, 20.f * std::sqrt(2.f)));
+
+        // an index past the vertices read so far leaves the scene as it was
+        {
+            std::ofstream file(path);
+            file << "v 0 0 0\nv 10 0 0\nv 10 10 0\n"
+                 << "f 1 2 3\nf -1 -2 -4\n";
+        }
+        check("an OBJ face naming a missing vertex adds nothing", !network.importMesh(path.string(), linalg::Vector(0.f, 0.f), 1.f) && scene.balls.size() == 5 && scene.springs.size() == 5);
+
+        std::filesystem::remove(path);
+    }
+
+    return hasFailed ? 1 : 0;
+}
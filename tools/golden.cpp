@@ -0,0 +1,165 @@
+// records reference trajectories of seeded scenes with the scalar step and checks other step functions against them
+// the references are committed in tests/golden, they are recorded again only when the scalar step changes on purpose
+//
+// g++ -O2 -std=c++17 tools/golden.cpp src/graphs/*.cpp src/physics/*.cpp -o build/golden <SFML flags>
+// build/golden check tests/golden [path]
+// build/golden record tests/golden
+#include "../include/physics/golden.hpp"
+#include "../include/physics/simulation.hpp"
+#include "../include/physics/domain.hpp"
+#include "../include/graphs/static-world.hpp"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+struct StepPath
+{
+    const char *name;
+    void (*step)();
+    physics::Tolerances tolerances;
+    int horizon;            // frames compared per object, 0 compares every particle over the whole run
+    float percentile;       // of the objects, the errors of the others are only reported
+    int domainCount;        // 0 runs the step on this process, otherwise it is run by that many worker processes
+};
+
+struct GoldenScene
+{
+    unsigned seed;
+    int numberOfBalls, numberOfSoftBodys;
+};
+
+// the first path is the reference, new implementations are added below it
+// the multi-rate step resolves the contacts between islands once per frame and the domains resolve them in another order, so single objects part from the reference after the first contacts
+// the tolerances are about one and a half times the errors measured at the percentile, in the scenes below: multi-rate 22 px and 470 px/s over 10 frames, domains 3.5 px and 185 px/s over 30 frames
+static const StepPath paths[] = {
+    {"scalar", physics::step, {0.5f, 5.f}, 0, 0.f, 0}, // pixels, pixels per second
+    {"multi-rate", physics::multiRateStep, {32.f, 700.f}, 10, 0.75f, 0},
+    {"domains", physics::step, {5.f, 280.f}, 30, 0.75f, 4},
+    {"domains multi-rate", physics::multiRateStep, {32.f, 700.f}, 10, 0.75f, 4},
+};
+
+static const GoldenScene scenes[] = {
+    {1, 5, 2},
+    {2, 30, 3},
+    {3, 80, 0},
+    {4, 0, 5},
+};
+
+static const int FRAMES = 300;
+
+static std::string scenePath(const std::string &directory, const GoldenScene &scene)
+{
+    return directory + "/scene-" + std::to_string(scene.seed) + ".gld";
+}
+
+// the coordinator of the path being checked, record only takes a plain function
+static physics::DomainCoordinator *coordinator = nullptr;
+static bool isWorkerLost = false;
+
+static void distributedStep()
+{
+    isWorkerLost = isWorkerLost || !coordinator->step();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: golden record <directory> | golden check <directory> [path]" << std::endl;
+        return 2;
+    }
+    std::string mode = argv[1];
+    std::string directory = argv[2];
+    std::string onlyPath = (argc > 3) ? argv[3] : "";
+
+    // the same static obstacles as the window
+    graphs::World.addPolyline({linalg::Vector(80.f, 620.f), linalg::Vector(300.f, 700.f), linalg::Vector(420.f, 700.f)});
+    graphs::World.addSegment(linalg::Vector(780.f, 720.f), linalg::Vector(1120.f, 600.f));
+    graphs::World.build();
+
+    if (mode == "record")
+    {
+        for (const GoldenScene &scene : scenes)
+        {
+            physics::Trajectory trajectory(scene.seed, scene.numberOfBalls, scene.numberOfSoftBodys);
+            trajectory.record(FRAMES, paths[0].step);
+            if (!trajectory.save(scenePath(directory, scene)))
+            {
+                std::cerr << "can not write " << scenePath(directory, scene) << std::endl;
+                return 2;
+            }
+            std::cout << "recorded scene " << scene.seed << ": " << trajectory.particleCount << " particles, " << FRAMES << " frames" << std::endl;
+        }
+        return 0;
+    }
+
+    bool hasFailed = false;
+    for (const StepPath &path : paths)
+    {
+        if (!onlyPath.empty() && onlyPath != path.name)
+        {
+            continue;
+        }
+
+        for (const GoldenScene &scene : scenes)
+        {
+            // a missing or outdated reference fails, otherwise the scalar step would only be compared with itself
+            physics::Trajectory reference;
+            std::cout << path.name << " scene " << scene.seed << ": ";
+            if (!reference.load(scenePath(directory, scene)))
+            {
+                hasFailed = true;
+                std::cout << "missing reference " << scenePath(directory, scene) << std::endl;
+                continue;
+            }
+            if (reference.seed != scene.seed || reference.numberOfBalls != scene.numberOfBalls || reference.numberOfSoftBodys != scene.numberOfSoftBodys || reference.frames != FRAMES)
+            {
+                hasFailed = true;
+                std::cout << "reference " << scenePath(directory, scene) << " was recorded for another scene" << std::endl;
+                continue;
+            }
+
+            // every scene gets new workers with the halo of the window, they keep the objects of the last frame
+            physics::DomainCoordinator domains(std::max(path.domainCount, 1), 150.f);
+            domains.stepWorld = path.step;
+            if (path.domainCount > 0 && !domains.start())
+            {
+                std::cout << "skipped, worker processes are not supported" << std::endl;
+                continue;
+            }
+            coordinator = &domains;
+            isWorkerLost = false;
+
+            physics::Trajectory candidate(reference.seed, reference.numberOfBalls, reference.numberOfSoftBodys);
+            candidate.record(reference.frames, (path.domainCount > 0) ? distributedStep : path.step);
+            if (isWorkerLost)
+            {
+                hasFailed = true;
+                std::cout << "a worker process was lost" << std::endl;
+                continue;
+            }
+            physics::Divergence divergence = (path.horizon > 0) ? physics::compareObjects(reference, candidate, path.tolerances, path.horizon, path.percentile)
+                                                                : physics::compareTrajectories(reference, candidate, path.tolerances);
+
+            if (divergence.hasDiverged)
+            {
+                hasFailed = true;
+                std::cout << "diverged at frame " << divergence.frame << ", " << divergence.object << ", " << divergence.quantity << " error " << divergence.error;
+            }
+            else
+            {
+                std::cout << "ok";
+            }
+            if (divergence.worstFrame < 0)
+            {
+                std::cout << " (no drift)" << std::endl;
+            }
+            else
+            {
+                std::cout << " (worst " << divergence.worstObject << ", " << divergence.worstPositionError << " px at frame " << divergence.worstFrame << ", rms " << divergence.rmsPositionDrift << " px)" << std::endl;
+            }
+        }
+    }
+
+    return hasFailed ? 1 : 0;
+}